@@ -0,0 +1,294 @@
+#ifndef ASYNC_DELIVERY_HPP
+#define ASYNC_DELIVERY_HPP
+
+#include "events.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Asynchronous delivery of typed events
+//
+// Events::WorkerPool pool{4};
+// auto dispatcher = std::make_shared<Events::AsyncDispatcher<StateChanged>>(pool);
+// device.subscribe<StateChanged>(dispatcher);
+// dispatcher->subscribe(slow_handler, Events::Conflation::latest_value_wins);
+//
+// - emit() only appends the event to the dispatcher's inbox - O(1) for any number of subscribers
+// - a worker fans events out to bounded mailboxes of subscribers
+// - each subscriber is delivered by at most one worker at a time - a slow handler delays only itself
+
+namespace Events
+{
+    class WorkerPool
+    {
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        std::queue<std::function<void()>> tasks_;
+        bool done_ = false;
+        std::vector<std::jthread> threads_;
+
+    public:
+        explicit WorkerPool(std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (std::size_t i = 0; i < thread_count; ++i)
+                threads_.emplace_back([this] { run(); });
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // pending tasks are completed before threads are joined
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard lk{mtx_};
+                done_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        void submit(std::function<void()> task)
+        {
+            {
+                std::lock_guard lk{mtx_};
+                tasks_.push(std::move(task));
+            }
+            cv_.notify_one();
+        }
+
+    private:
+        void run()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock lk{mtx_};
+                    cv_.wait(lk, [this] { return done_ || !tasks_.empty(); });
+                    if (tasks_.empty())
+                        return;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop();
+                }
+
+                task();
+            }
+        }
+    };
+
+    enum class Conflation
+    {
+        latest_value_wins, // pending event is replaced by a newer one
+        batch_all          // all events are delivered in order - the oldest are dropped when a mailbox is full
+    };
+
+    struct DeliveryStats
+    {
+        std::size_t posted = 0;    // events emitted to the dispatcher
+        std::size_t delivered = 0; // calls of handlers
+        std::size_t conflated = 0; // events replaced by newer ones (latest_value_wins)
+        std::size_t dropped = 0;   // events evicted from full mailboxes (or the full inbox)
+    };
+
+    template <typename TEvent>
+    class AsyncDispatcher : public Handler<TEvent>
+    {
+        struct Mailbox
+        {
+            std::weak_ptr<Handler<TEvent>> handler;
+            Conflation conflation;
+            std::size_t capacity;
+
+            std::mutex mtx;
+            std::deque<TEvent> events;
+            bool scheduled = false; // delivery task is pending or running
+        };
+
+        WorkerPool& pool_;
+        const std::size_t inbox_capacity_;
+
+        std::mutex mtx_inbox_;
+        std::deque<TEvent> inbox_;
+        bool fan_out_scheduled_ = false;
+
+        std::mutex mtx_mailboxes_;
+        std::vector<std::shared_ptr<Mailbox>> mailboxes_;
+
+        std::atomic<std::size_t> posted_{0}, delivered_{0}, conflated_{0}, dropped_{0};
+
+        std::mutex mtx_tasks_;
+        std::condition_variable cv_idle_;
+        std::size_t tasks_in_flight_ = 0;
+
+    public:
+        explicit AsyncDispatcher(WorkerPool& pool, std::size_t inbox_capacity = 1024)
+            : pool_{pool}
+            , inbox_capacity_{inbox_capacity}
+        {
+            if (inbox_capacity == 0)
+                throw std::invalid_argument("Inbox capacity must be > 0");
+        }
+
+        AsyncDispatcher(const AsyncDispatcher&) = delete;
+        AsyncDispatcher& operator=(const AsyncDispatcher&) = delete;
+
+        ~AsyncDispatcher() override
+        {
+            wait_idle();
+        }
+
+        void subscribe(std::weak_ptr<Handler<TEvent>> handler, Conflation conflation, std::size_t capacity = 64)
+        {
+            if (capacity == 0)
+                throw std::invalid_argument("Mailbox capacity must be > 0");
+
+            auto mailbox = std::make_shared<Mailbox>();
+            mailbox->handler = std::move(handler);
+            mailbox->conflation = conflation;
+            mailbox->capacity = capacity;
+
+            std::lock_guard lk{mtx_mailboxes_};
+            mailboxes_.push_back(std::move(mailbox));
+        }
+
+        // producer side - called by EventSource::emit()
+        void on_event(const TEvent& event) override
+        {
+            ++posted_;
+
+            {
+                std::lock_guard lk{mtx_inbox_};
+                if (inbox_.size() == inbox_capacity_)
+                {
+                    inbox_.pop_front();
+                    ++dropped_;
+                }
+                inbox_.push_back(event);
+
+                if (std::exchange(fan_out_scheduled_, true))
+                    return;
+            }
+
+            schedule([this] { fan_out(); });
+        }
+
+        // blocks until all posted events are delivered (or dropped)
+        void wait_idle()
+        {
+            std::unique_lock lk{mtx_tasks_};
+            cv_idle_.wait(lk, [this] { return tasks_in_flight_ == 0; });
+        }
+
+        DeliveryStats stats() const
+        {
+            return DeliveryStats{posted_.load(), delivered_.load(), conflated_.load(), dropped_.load()};
+        }
+
+    private:
+        template <typename Task>
+        void schedule(Task task)
+        {
+            {
+                std::lock_guard lk{mtx_tasks_};
+                ++tasks_in_flight_;
+            }
+
+            pool_.submit([this, task = std::move(task)] {
+                task();
+
+                std::lock_guard lk{mtx_tasks_};
+                if (--tasks_in_flight_ == 0)
+                    cv_idle_.notify_all();
+            });
+        }
+
+        void fan_out()
+        {
+            std::deque<TEvent> events;
+            {
+                std::lock_guard lk{mtx_inbox_};
+                events.swap(inbox_);
+                fan_out_scheduled_ = false;
+            }
+
+            std::vector<std::shared_ptr<Mailbox>> mailboxes;
+            {
+                std::lock_guard lk{mtx_mailboxes_};
+                std::erase_if(mailboxes_, [](const auto& mailbox) { return mailbox->handler.expired(); });
+                mailboxes = mailboxes_;
+            }
+
+            for (const auto& mailbox : mailboxes)
+            {
+                {
+                    std::lock_guard lk{mailbox->mtx};
+                    for (const TEvent& event : events)
+                        post(*mailbox, event);
+
+                    if (std::exchange(mailbox->scheduled, true))
+                        continue;
+                }
+
+                schedule([this, mailbox] { deliver(*mailbox); });
+            }
+        }
+
+        void post(Mailbox& mailbox, const TEvent& event)
+        {
+            if (mailbox.conflation == Conflation::latest_value_wins && !mailbox.events.empty())
+            {
+                mailbox.events.back() = event;
+                ++conflated_;
+                return;
+            }
+
+            if (mailbox.events.size() == mailbox.capacity)
+            {
+                mailbox.events.pop_front();
+                ++dropped_;
+            }
+            mailbox.events.push_back(event);
+        }
+
+        void deliver(Mailbox& mailbox)
+        {
+            while (true)
+            {
+                std::deque<TEvent> events;
+                {
+                    std::lock_guard lk{mailbox.mtx};
+                    if (mailbox.events.empty())
+                    {
+                        mailbox.scheduled = false;
+                        return;
+                    }
+                    events.swap(mailbox.events);
+                }
+
+                std::shared_ptr<Handler<TEvent>> handler = mailbox.handler.lock();
+                if (!handler)
+                    continue; // expired - pending events are discarded
+
+                for (const TEvent& event : events)
+                    handler->on_event(event);
+
+                delivered_ += events.size();
+            }
+        }
+    };
+} // namespace Events
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include "observer_list.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// Typed events - structured payloads instead of preformatted strings
+//
+// struct StateChanged { int old_state, new_state; };
+//
+// class Device : public Events::EventSource<StateChanged> { ... emit<StateChanged>(0, 1); ... };
+// device.subscribe<StateChanged>(handler); // handler: weak_ptr<Events::Handler<StateChanged>>
+//
+// - an event is constructed only if it has at least one subscriber
+// - an event is passed by const reference - formatting is left to handlers that need text
+// - emitting allocates nothing (after the first notification on a thread)
+
+namespace Events
+{
+    template <typename TEvent>
+    class Handler
+    {
+    public:
+        virtual void on_event(const TEvent& event) = 0;
+        virtual ~Handler() = default;
+    };
+
+    template <typename... TEvents>
+    class EventSource
+    {
+        std::tuple<Observers::ObserverList<Handler<TEvents>>...> handlers_;
+
+        template <typename TEvent>
+        Observers::ObserverList<Handler<TEvent>>& handlers_of()
+        {
+            return std::get<Observers::ObserverList<Handler<TEvent>>>(handlers_);
+        }
+
+        template <typename TEvent>
+        const Observers::ObserverList<Handler<TEvent>>& handlers_of() const
+        {
+            return std::get<Observers::ObserverList<Handler<TEvent>>>(handlers_);
+        }
+
+    public:
+        template <typename TEvent>
+        void subscribe(std::weak_ptr<Handler<TEvent>> handler)
+        {
+            handlers_of<TEvent>().add(std::move(handler));
+        }
+
+        template <typename TEvent>
+        void unsubscribe(const std::shared_ptr<Handler<TEvent>>& handler)
+        {
+            handlers_of<TEvent>().remove(handler);
+        }
+
+        template <typename TEvent>
+        bool has_subscribers() const
+        {
+            return !handlers_of<TEvent>().empty();
+        }
+
+    protected:
+        // returns number of notified handlers
+        template <typename TEvent, typename... TArgs>
+        std::size_t emit(TArgs&&... args) const
+        {
+            const auto& handlers = handlers_of<TEvent>();
+            if (handlers.empty())
+                return 0;
+
+            const TEvent event{std::forward<TArgs>(args)...};
+            return handlers.for_each([&event](Handler<TEvent>& handler) { handler.on_event(event); });
+        }
+    };
+} // namespace Events
+
+#endif
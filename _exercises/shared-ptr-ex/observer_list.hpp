@@ -0,0 +1,95 @@
+#ifndef OBSERVER_LIST_HPP
+#define OBSERVER_LIST_HPP
+
+#include <snapshot.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// ObserverList - thread-safe list of weak_ptr-tracked observers
+//
+// - observers are kept in a contiguous vector published as an immutable snapshot
+// - for_each() (notify) never waits for registration - it iterates the current snapshot
+// - add/remove copy the vector under a writer lock (copy-on-write)
+// - expired observers are skipped by for_each() & pruned by the next add/remove/prune
+
+namespace Observers
+{
+    template <typename TObserver>
+    class ObserverList
+    {
+        using Observers = std::vector<std::weak_ptr<TObserver>>;
+
+        Concurrency::Snapshot<Observers> observers_;
+        mutable std::atomic<bool> has_expired_{false};
+
+    public:
+        void add(std::weak_ptr<TObserver> observer)
+        {
+            observers_.update([&](Observers& observers) {
+                prune_expired(observers);
+                observers.push_back(std::move(observer));
+            });
+        }
+
+        void remove(const std::shared_ptr<TObserver>& observer)
+        {
+            observers_.update([&](Observers& observers) {
+                std::erase_if(observers, [&](const std::weak_ptr<TObserver>& item) {
+                    return item.expired() || (!item.owner_before(observer) && !observer.owner_before(item));
+                });
+            });
+        }
+
+        void prune()
+        {
+            if (has_expired_.load(std::memory_order_relaxed))
+                observers_.update([this](Observers& observers) { prune_expired(observers); });
+        }
+
+        // calls f for every living observer - returns number of notified observers
+        template <typename F>
+        std::size_t for_each(F&& f) const
+        {
+            return observers_.read([&](const Observers& observers) {
+                std::size_t notified = 0;
+                for (const std::weak_ptr<TObserver>& observer : observers)
+                {
+                    if (std::shared_ptr<TObserver> living_observer = observer.lock())
+                    {
+                        f(*living_observer);
+                        ++notified;
+                    }
+                    else
+                        has_expired_.store(true, std::memory_order_relaxed);
+                }
+                return notified;
+            });
+        }
+
+        // number of registered observers (including expired but not yet pruned)
+        std::size_t size() const
+        {
+            return observers_.read([](const Observers& observers) { return observers.size(); });
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+    private:
+        void prune_expired(Observers& observers)
+        {
+            has_expired_.store(false, std::memory_order_relaxed);
+            std::erase_if(observers, [](const std::weak_ptr<TObserver>& observer) { return observer.expired(); });
+        }
+    };
+} // namespace Observers
+
+#endif
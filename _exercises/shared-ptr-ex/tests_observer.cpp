@@ -1,9 +1,23 @@
+#include "async_delivery.hpp"
+#include "events.hpp"
+#include "observer_list.hpp"
+
+#include <alloc_tracker.hpp>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <latch>
+#include <memory>
+#include <ostream>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 class Observer
@@ -52,6 +66,46 @@ protected:
     }
 };
 
+// thread-safe subject - observers are tracked by weak_ptrs
+class ConcurrentSubject
+{
+    std::atomic<int> state_{0};
+    Observers::ObserverList<Observer> observers_;
+
+public:
+    void register_observer(std::weak_ptr<Observer> observer)
+    {
+        observers_.add(std::move(observer));
+    }
+
+    void unregister_observer(const std::shared_ptr<Observer>& observer)
+    {
+        observers_.remove(observer);
+    }
+
+    void set_state(int new_state)
+    {
+        if (state_.exchange(new_state) != new_state && !observers_.empty()) // no text without observers
+            notify("Changed state on: " + std::to_string(new_state));
+    }
+
+    std::size_t observer_count() const
+    {
+        return observers_.size();
+    }
+
+    void prune_observers()
+    {
+        observers_.prune();
+    }
+
+protected:
+    std::size_t notify(const std::string& event_args)
+    {
+        return observers_.for_each([&](Observer& observer) { observer.update(event_args); });
+    }
+};
+
 class ConcreteObserver1 : public Observer
 {
 public:
@@ -92,3 +146,358 @@ TEST_CASE("using observer pattern")
 
     // s.set_state(2);
 }
+
+namespace
+{
+    class CountingObserver : public Observer
+    {
+    public:
+        int count = 0;
+        std::string last_event;
+
+        void update(const std::string& event) override
+        {
+            ++count;
+            last_event = event;
+        }
+    };
+} // namespace
+
+TEST_CASE("concurrent subject - weak_ptr observers")
+{
+    ConcurrentSubject s;
+
+    auto o1 = std::make_shared<CountingObserver>();
+    s.register_observer(o1);
+
+    {
+        auto o2 = std::make_shared<CountingObserver>();
+        s.register_observer(o2);
+
+        s.set_state(1);
+        CHECK(o2->count == 1);
+    } // o2 is destroyed - no dangling pointer in the subject
+
+    s.set_state(2);
+    CHECK(o1->count == 2);
+    CHECK(o1->last_event == "Changed state on: 2");
+
+    SECTION("expired observers are pruned lazily")
+    {
+        CHECK(s.observer_count() == 2);
+        s.prune_observers();
+        CHECK(s.observer_count() == 1);
+    }
+
+    SECTION("unregistering")
+    {
+        s.unregister_observer(o1);
+        s.set_state(3);
+        CHECK(o1->count == 2);
+        CHECK(s.observer_count() == 0);
+    }
+}
+
+TEST_CASE("concurrent subject - notify during registration")
+{
+    ConcurrentSubject s;
+
+    auto permanent = std::make_shared<CountingObserver>();
+    s.register_observer(permanent);
+
+    {
+        std::jthread registrar{[&s](std::stop_token stop) {
+            while (!stop.stop_requested())
+            {
+                auto temporary = std::make_shared<CountingObserver>();
+                s.register_observer(temporary);
+                s.unregister_observer(temporary);
+            }
+        }};
+
+        for (int i = 1; i <= 10'000; ++i)
+            s.set_state(i);
+    }
+
+    CHECK(permanent->count == 10'000);
+}
+
+TEST_CASE("concurrent subject - benchmark", "[.benchmark]")
+{
+    for (int observer_count : {1, 10, 100, 1'000, 10'000})
+    {
+        BENCHMARK_ADVANCED("notify " + std::to_string(observer_count) + " observers - concurrent registration")(Catch::Benchmark::Chronometer meter)
+        {
+            ConcurrentSubject s;
+
+            std::vector<std::shared_ptr<CountingObserver>> observers;
+            for (int i = 0; i < observer_count; ++i)
+            {
+                observers.push_back(std::make_shared<CountingObserver>());
+                s.register_observer(observers.back());
+            }
+
+            std::jthread registrar{[&s](std::stop_token stop) {
+                while (!stop.stop_requested())
+                {
+                    auto temporary = std::make_shared<CountingObserver>();
+                    s.register_observer(temporary);
+                    s.unregister_observer(temporary);
+                    std::this_thread::yield();
+                }
+            }};
+
+            int state = 0;
+            meter.measure([&] {
+                for (int i = 0; i < 100; ++i)
+                    s.set_state(++state);
+                return state;
+            });
+        };
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// typed events
+
+struct StateChanged
+{
+    inline static int constructed_count = 0;
+
+    int old_state;
+    int new_state;
+
+    StateChanged(int old_state, int new_state)
+        : old_state{old_state}
+        , new_state{new_state}
+    {
+        ++constructed_count;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const StateChanged& event)
+    {
+        return out << "Changed state on: " << event.new_state;
+    }
+};
+
+struct Reset
+{
+};
+
+class Device : public Events::EventSource<StateChanged, Reset>
+{
+    int state_ = 0;
+
+public:
+    void set_state(int new_state)
+    {
+        if (state_ != new_state)
+            emit<StateChanged>(std::exchange(state_, new_state), new_state);
+    }
+
+    void reset()
+    {
+        state_ = 0;
+        emit<Reset>();
+    }
+};
+
+namespace
+{
+    class StateRecorder : public Events::Handler<StateChanged>
+    {
+    public:
+        int count = 0;
+        int last_state = 0;
+
+        void on_event(const StateChanged& event) override
+        {
+            ++count;
+            last_state = event.new_state;
+        }
+    };
+
+    // text is formatted only by handlers that need it
+    class StateLogger : public Events::Handler<StateChanged>
+    {
+    public:
+        std::ostringstream log;
+
+        void on_event(const StateChanged& event) override
+        {
+            log << event << '\n';
+        }
+    };
+
+    class ResetCounter : public Events::Handler<Reset>
+    {
+    public:
+        int count = 0;
+
+        void on_event(const Reset&) override
+        {
+            ++count;
+        }
+    };
+} // namespace
+
+TEST_CASE("typed events")
+{
+    Device device;
+
+    SECTION("event is not constructed without subscribers")
+    {
+        const int constructed_before = StateChanged::constructed_count;
+        device.set_state(1);
+        CHECK(StateChanged::constructed_count == constructed_before);
+    }
+
+    SECTION("handlers subscribe to event types")
+    {
+        auto recorder = std::make_shared<StateRecorder>();
+        auto logger = std::make_shared<StateLogger>();
+        auto reset_counter = std::make_shared<ResetCounter>();
+        device.subscribe<StateChanged>(recorder);
+        device.subscribe<StateChanged>(logger);
+        device.subscribe<Reset>(reset_counter);
+
+        device.set_state(1);
+        device.set_state(2);
+        device.reset();
+
+        CHECK(recorder->count == 2);
+        CHECK(recorder->last_state == 2);
+        CHECK(logger->log.str() == "Changed state on: 1\nChanged state on: 2\n");
+        CHECK(reset_counter->count == 1);
+
+        device.unsubscribe<StateChanged>(recorder);
+        device.set_state(3);
+        CHECK(recorder->count == 2);
+    }
+
+    SECTION("notifications allocate nothing in steady state")
+    {
+        auto recorder = std::make_shared<StateRecorder>();
+        device.subscribe<StateChanged>(recorder);
+        device.set_state(1); // warm-up - thread's hazard pointer cache
+
+        AllocTracker::Scope scope;
+
+        for (int i = 2; i < 1'000; ++i)
+            device.set_state(i);
+
+        CHECK(scope.allocations() == 0);
+        CHECK(recorder->count == 999);
+    }
+}
+
+TEST_CASE("typed events - async delivery")
+{
+    using namespace std::literals;
+
+    Events::WorkerPool pool{2};
+    Device device;
+
+    auto dispatcher = std::make_shared<Events::AsyncDispatcher<StateChanged>>(pool);
+    device.subscribe<StateChanged>(dispatcher);
+
+    SECTION("batch_all delivers every event in order")
+    {
+        auto logger = std::make_shared<StateLogger>();
+        dispatcher->subscribe(logger, Events::Conflation::batch_all);
+
+        for (int i = 1; i <= 3; ++i)
+            device.set_state(i);
+
+        dispatcher->wait_idle();
+
+        CHECK(logger->log.str() == "Changed state on: 1\nChanged state on: 2\nChanged state on: 3\n");
+        CHECK(dispatcher->stats().delivered == 3);
+    }
+
+    SECTION("slow handler gets the latest value - producer is not stalled")
+    {
+        // blocks on its first event until the producer is done
+        class SlowRecorder : public StateRecorder
+        {
+        public:
+            std::latch producer_done{1};
+
+            void on_event(const StateChanged& event) override
+            {
+                producer_done.wait();
+                StateRecorder::on_event(event);
+            }
+        };
+
+        auto slow = std::make_shared<SlowRecorder>();
+        auto fast = std::make_shared<StateRecorder>();
+        dispatcher->subscribe(slow, Events::Conflation::latest_value_wins);
+        dispatcher->subscribe(fast, Events::Conflation::batch_all, 10'000);
+
+        for (int i = 1; i <= 1'000; ++i) // would deadlock if posting waited for the slow handler
+            device.set_state(i);
+        slow->producer_done.count_down();
+
+        dispatcher->wait_idle();
+
+        CHECK(slow->last_state == 1'000);
+        CHECK(slow->count <= 2); // an event taken before the producer finished + the latest one
+        CHECK(fast->count == 1'000);
+
+        const Events::DeliveryStats stats = dispatcher->stats();
+        CHECK(stats.posted == 1'000);
+        CHECK(stats.conflated == 1'000 - static_cast<std::size_t>(slow->count));
+        CHECK(stats.delivered == 1'000 + static_cast<std::size_t>(slow->count));
+        CHECK(stats.dropped == 0);
+    }
+
+    SECTION("full mailbox drops the oldest events")
+    {
+        auto recorder = std::make_shared<StateRecorder>();
+        dispatcher->subscribe(recorder, Events::Conflation::batch_all, 1);
+
+        for (int i = 1; i <= 100; ++i)
+            device.set_state(i);
+
+        dispatcher->wait_idle();
+
+        const Events::DeliveryStats stats = dispatcher->stats();
+        CHECK(recorder->last_state == 100);
+        CHECK(stats.delivered + stats.dropped == 100);
+    }
+}
+
+TEST_CASE("typed events - producer latency benchmark", "[.benchmark]")
+{
+    const int observer_count = 1'000;
+
+    std::vector<std::shared_ptr<StateRecorder>> recorders;
+    for (int i = 0; i < observer_count; ++i)
+        recorders.push_back(std::make_shared<StateRecorder>());
+
+    BENCHMARK_ADVANCED("set_state - synchronous, 1000 handlers")(Catch::Benchmark::Chronometer meter)
+    {
+        Device device;
+        for (const auto& recorder : recorders)
+            device.subscribe<StateChanged>(recorder);
+
+        int state = 0;
+        meter.measure([&] { device.set_state(++state); });
+    };
+
+    BENCHMARK_ADVANCED("set_state - async latest_value_wins, 1000 handlers")(Catch::Benchmark::Chronometer meter)
+    {
+        Events::WorkerPool pool{2};
+        Device device;
+        auto dispatcher = std::make_shared<Events::AsyncDispatcher<StateChanged>>(pool);
+        device.subscribe<StateChanged>(dispatcher);
+        for (const auto& recorder : recorders)
+            dispatcher->subscribe(recorder, Events::Conflation::latest_value_wins);
+
+        int state = 0;
+        meter.measure([&] { device.set_state(++state); });
+
+        dispatcher->wait_idle();
+    };
+}
@@ -0,0 +1,249 @@
+#include "alloc_tracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace
+{
+    // trivial type - constant initialized, no TLS guard on access
+    thread_local AllocTracker::Stats tls_stats{};
+
+    // every block is preceded by a header keeping the requested size
+    constexpr std::size_t header_size = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    void record_allocation(std::size_t size) noexcept
+    {
+        ++tls_stats.allocations;
+        tls_stats.bytes_allocated += size;
+        tls_stats.live_bytes += static_cast<std::int64_t>(size);
+        tls_stats.peak_live_bytes = std::max(tls_stats.peak_live_bytes, tls_stats.live_bytes);
+        ++tls_stats.size_histogram[AllocTracker::bucket_of(size)];
+    }
+
+    void record_deallocation(std::size_t size) noexcept
+    {
+        ++tls_stats.deallocations;
+        tls_stats.bytes_deallocated += size;
+        tls_stats.live_bytes -= static_cast<std::int64_t>(size);
+    }
+
+    std::size_t& stored_size(void* ptr) noexcept
+    {
+        return *(static_cast<std::size_t*>(ptr) - 1);
+    }
+
+    // the MSVC CRT has no std::aligned_alloc - its blocks must be released by _aligned_free
+    void* aligned_malloc(std::size_t size, std::size_t alignment) noexcept
+    {
+#ifdef _MSC_VER
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    void aligned_free(void* raw) noexcept
+    {
+#ifdef _MSC_VER
+        _aligned_free(raw);
+#else
+        std::free(raw);
+#endif
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment = header_size) noexcept
+    {
+        alignment = std::max(alignment, header_size);
+
+        void* raw = (alignment == header_size)
+            ? std::malloc(size + header_size)
+            : aligned_malloc(size + alignment, alignment);
+
+        if (!raw)
+            return nullptr;
+
+        void* ptr = static_cast<std::byte*>(raw) + alignment;
+        stored_size(ptr) = size;
+        record_allocation(size);
+
+        return ptr;
+    }
+
+    void* allocate_or_throw(std::size_t size, std::size_t alignment = header_size)
+    {
+        while (true)
+        {
+            if (void* ptr = allocate(size, alignment))
+                return ptr;
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc{};
+
+            handler();
+        }
+    }
+
+    void deallocate(void* ptr, std::size_t alignment = header_size) noexcept
+    {
+        if (!ptr)
+            return;
+
+        record_deallocation(stored_size(ptr));
+
+        alignment = std::max(alignment, header_size);
+        void* raw = static_cast<std::byte*>(ptr) - alignment;
+        if (alignment == header_size)
+            std::free(raw);
+        else
+            aligned_free(raw);
+    }
+} // namespace
+
+namespace AllocTracker
+{
+    const Stats& thread_stats() noexcept
+    {
+        return tls_stats;
+    }
+
+    Scope::Scope() noexcept
+        : start_{tls_stats}
+        , outer_peak_{tls_stats.peak_live_bytes}
+    {
+        tls_stats.peak_live_bytes = tls_stats.live_bytes;
+    }
+
+    Scope::~Scope()
+    {
+        tls_stats.peak_live_bytes = std::max(outer_peak_, tls_stats.peak_live_bytes);
+    }
+
+    Stats Scope::stats() const noexcept
+    {
+        const Stats& now = tls_stats;
+
+        Stats delta{};
+        delta.allocations = now.allocations - start_.allocations;
+        delta.deallocations = now.deallocations - start_.deallocations;
+        delta.bytes_allocated = now.bytes_allocated - start_.bytes_allocated;
+        delta.bytes_deallocated = now.bytes_deallocated - start_.bytes_deallocated;
+        delta.live_bytes = now.live_bytes - start_.live_bytes;
+        delta.peak_live_bytes = now.peak_live_bytes - start_.live_bytes;
+        for (std::size_t i = 0; i < histogram_size; ++i)
+            delta.size_histogram[i] = now.size_histogram[i] - start_.size_histogram[i];
+
+        return delta;
+    }
+} // namespace AllocTracker
+
+////////////////////////////////////////////////////////////////////////////
+// replaceable allocation functions
+
+void* operator new(std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// replaceable deallocation functions
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr, static_cast<std::size_t>(alignment));
+}
@@ -0,0 +1,79 @@
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////
+// Allocation tracker - counts heap traffic of the current thread
+//
+// Linking alloc-tracker replaces global operator new/delete. Counters are
+// plain thread_local integers, so tracking is cheap enough to stay enabled
+// in benchmark builds.
+
+namespace AllocTracker
+{
+    // bucket i counts allocations with size in [2^(i-1), 2^i) - bucket 0 is for size 0
+    constexpr std::size_t histogram_size = 32;
+
+    constexpr std::size_t bucket_of(std::size_t size)
+    {
+        std::size_t bucket = std::bit_width(size);
+        return bucket < histogram_size ? bucket : histogram_size - 1;
+    }
+
+    struct Stats
+    {
+        std::size_t allocations;
+        std::size_t deallocations;
+        std::size_t bytes_allocated;
+        std::size_t bytes_deallocated;
+        std::int64_t live_bytes; // may go negative when memory is released by another thread
+        std::int64_t peak_live_bytes;
+        std::array<std::size_t, histogram_size> size_histogram;
+    };
+
+    // counters of the calling thread since its start
+    const Stats& thread_stats() noexcept;
+
+    // snapshot of the calling thread's counters - reports allocations done during its lifetime
+    class Scope
+    {
+        Stats start_;
+        std::int64_t outer_peak_;
+
+    public:
+        Scope() noexcept;
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        Stats stats() const noexcept;
+
+        std::size_t allocations() const noexcept
+        {
+            return thread_stats().allocations - start_.allocations;
+        }
+
+        std::size_t deallocations() const noexcept
+        {
+            return thread_stats().deallocations - start_.deallocations;
+        }
+
+        std::size_t bytes_allocated() const noexcept
+        {
+            return thread_stats().bytes_allocated - start_.bytes_allocated;
+        }
+
+        // peak of live bytes above the level at the start of the scope
+        std::int64_t peak_live_bytes() const noexcept
+        {
+            return thread_stats().peak_live_bytes - start_.live_bytes;
+        }
+    };
+} // namespace AllocTracker
+
+#endif
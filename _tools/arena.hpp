@@ -0,0 +1,162 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// Arena - bump-pointer allocator for objects that die together
+//
+// {
+//     Memory::Arena arena;
+//     Gadget* g = arena.create<Gadget>(1, "ipad");
+//     std::pmr::vector<int> vec{&arena};
+// } // destructors of created objects are called, all chunks are released
+//
+// - deallocation of single objects is a no-op (like std::pmr::monotonic_buffer_resource)
+// - destructors are registered only for non-trivially destructible types
+// - teardown: destructor calls + one release per chunk
+
+namespace Memory
+{
+    class Arena : public std::pmr::memory_resource
+    {
+        struct Chunk
+        {
+            Chunk* next;
+            std::size_t size; // including this header
+        };
+
+        struct DestructorNode
+        {
+            void (*destroy)(void*);
+            void* object;
+            DestructorNode* next;
+        };
+
+        static constexpr std::size_t max_chunk_size = 1024 * 1024;
+
+        std::pmr::memory_resource* upstream_;
+        std::size_t next_chunk_size_;
+        Chunk* chunks_ = nullptr;
+        std::byte* current_ = nullptr;
+        std::byte* end_ = nullptr;
+        DestructorNode* destructors_ = nullptr;
+        std::size_t bytes_reserved_ = 0;
+
+    public:
+        explicit Arena(std::size_t initial_chunk_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : upstream_{upstream}
+            , next_chunk_size_{std::max(initial_chunk_size, sizeof(Chunk) + alignof(std::max_align_t))}
+        {
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() override
+        {
+            release();
+        }
+
+        template <typename T, typename... TArgs>
+        T* create(TArgs&&... args)
+        {
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+            }
+            else
+            {
+                // node is allocated first - registration can't fail after construction
+                auto* node = static_cast<DestructorNode*>(allocate(sizeof(DestructorNode), alignof(DestructorNode)));
+                T* object = ::new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+
+                destructors_ = ::new (node) DestructorNode{[](void* ptr) { static_cast<T*>(ptr)->~T(); }, object, destructors_};
+
+                return object;
+            }
+        }
+
+        // calls destructors (in reverse order of creation) & returns all chunks to upstream
+        void release() noexcept
+        {
+            for (DestructorNode* node = destructors_; node; node = node->next)
+                node->destroy(node->object);
+            destructors_ = nullptr;
+
+            while (chunks_)
+            {
+                Chunk* next = chunks_->next;
+                upstream_->deallocate(chunks_, chunks_->size, alignof(Chunk));
+                chunks_ = next;
+            }
+
+            current_ = end_ = nullptr;
+            bytes_reserved_ = 0;
+        }
+
+        std::size_t bytes_reserved() const noexcept
+        {
+            return bytes_reserved_;
+        }
+
+        std::pmr::memory_resource* upstream_resource() const noexcept
+        {
+            return upstream_;
+        }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            if (void* ptr = bump(bytes, alignment))
+                return ptr;
+
+            add_chunk(bytes, alignment);
+
+            return bump(bytes, alignment);
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        void* bump(std::size_t bytes, std::size_t alignment) noexcept
+        {
+            void* ptr = current_;
+            std::size_t space = static_cast<std::size_t>(end_ - current_);
+            if (!std::align(alignment, bytes, ptr, space))
+                return nullptr;
+
+            current_ = static_cast<std::byte*>(ptr) + bytes;
+
+            return ptr;
+        }
+
+        void add_chunk(std::size_t bytes, std::size_t alignment)
+        {
+            const std::size_t size = std::max(next_chunk_size_, sizeof(Chunk) + bytes + alignment);
+
+            auto* chunk = ::new (upstream_->allocate(size, alignof(Chunk))) Chunk{chunks_, size};
+            chunks_ = chunk;
+            current_ = reinterpret_cast<std::byte*>(chunk) + sizeof(Chunk);
+            end_ = reinterpret_cast<std::byte*>(chunk) + size;
+            bytes_reserved_ += size;
+
+            next_chunk_size_ = std::min(2 * next_chunk_size_, max_chunk_size);
+        }
+    };
+} // namespace Memory
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef HAZARD_POINTERS_HPP
+#define HAZARD_POINTERS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Hazard pointers - deferred reclamation for objects read via atomic links
+//
+// reader:  Hazard::guarded_read(link, [](const Human* h) { ... });
+// writer:  auto* old = link.exchange(new_value);
+//          Hazard::retire(old); // deleted when no reader protects it
+//
+// A read publishes the pointer in a slot owned by the reading thread - no
+// writes to the shared object (unlike weak_ptr::lock on a control block).
+
+namespace Hazard
+{
+    class Domain
+    {
+    public:
+        static constexpr std::size_t max_hazard_pointers = 256;
+
+        struct alignas(64) Record // one cache line per slot - readers don't share lines
+        {
+            std::atomic<const void*> ptr{nullptr};
+            std::atomic<bool> active{false};
+        };
+
+        static Domain& global()
+        {
+            static Domain domain;
+            return domain;
+        }
+
+        Domain() = default;
+        Domain(const Domain&) = delete;
+        Domain& operator=(const Domain&) = delete;
+
+        // no readers may be left when a domain is destroyed
+        ~Domain()
+        {
+            while (!retired_.empty()) // deleters may retire further objects
+                delete_all(std::exchange(retired_, {}));
+        }
+
+        Record* acquire()
+        {
+            for (Record& record : records_)
+            {
+                bool expected = false;
+                if (!record.active.load(std::memory_order_relaxed) && record.active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return &record;
+            }
+
+            throw std::runtime_error("Too many hazard pointers");
+        }
+
+        void release(Record* record) noexcept
+        {
+            record->ptr.store(nullptr, std::memory_order_release);
+            record->active.store(false, std::memory_order_release);
+        }
+
+        template <typename T>
+        void retire(T* ptr)
+        {
+            retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+        }
+
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            if (!ptr)
+                return;
+
+            std::vector<Retired> reclaimable;
+            {
+                std::lock_guard lk{mtx_retired_};
+                retired_.push_back(Retired{ptr, deleter});
+                if (retired_.size() >= 2 * max_hazard_pointers)
+                    reclaimable = scan();
+            }
+
+            delete_all(std::move(reclaimable));
+        }
+
+        // deletes all retired objects that are not protected (also those retired by their destructors)
+        // - returns number of objects still pending
+        std::size_t reclaim()
+        {
+            while (true)
+            {
+                std::vector<Retired> reclaimable;
+                std::size_t pending;
+                {
+                    std::lock_guard lk{mtx_retired_};
+                    reclaimable = scan();
+                    pending = retired_.size();
+                }
+
+                if (reclaimable.empty())
+                    return pending;
+
+                delete_all(std::move(reclaimable));
+            }
+        }
+
+    private:
+        struct Retired
+        {
+            void* ptr;
+            void (*deleter)(void*);
+        };
+
+        std::array<Record, max_hazard_pointers> records_;
+        std::mutex mtx_retired_;
+        std::vector<Retired> retired_;
+
+        // moves out retired objects which are not protected - they are deleted after unlocking,
+        // so a destructor retiring other objects doesn't deadlock on mtx_retired_
+        std::vector<Retired> scan()
+        {
+            std::vector<const void*> hazards;
+            hazards.reserve(max_hazard_pointers);
+            for (const Record& record : records_)
+            {
+                if (const void* ptr = record.ptr.load(std::memory_order_seq_cst))
+                    hazards.push_back(ptr);
+            }
+            std::sort(hazards.begin(), hazards.end());
+
+            auto still_protected = std::partition(retired_.begin(), retired_.end(), [&](const Retired& retired) {
+                return std::binary_search(hazards.begin(), hazards.end(), retired.ptr);
+            });
+
+            std::vector<Retired> reclaimable(still_protected, retired_.end());
+            retired_.erase(still_protected, retired_.end());
+            return reclaimable;
+        }
+
+        static void delete_all(std::vector<Retired> reclaimable)
+        {
+            for (const Retired& retired : reclaimable)
+                retired.deleter(retired.ptr);
+        }
+    };
+
+    namespace Detail
+    {
+        // records are acquired once per thread & reused - a read does no scan of the domain
+        class RecordCache
+        {
+            std::vector<Domain::Record*> free_records_;
+
+        public:
+            ~RecordCache()
+            {
+                for (Domain::Record* record : free_records_)
+                    Domain::global().release(record);
+            }
+
+            Domain::Record* pop()
+            {
+                if (free_records_.empty())
+                    return Domain::global().acquire();
+
+                Domain::Record* record = free_records_.back();
+                free_records_.pop_back();
+                return record;
+            }
+
+            void push(Domain::Record* record)
+            {
+                free_records_.push_back(record);
+            }
+        };
+
+        inline RecordCache& record_cache()
+        {
+            thread_local RecordCache cache;
+            return cache;
+        }
+    } // namespace Detail
+
+    // owns a hazard slot of the global domain
+    class HazardPointer
+    {
+        Domain::Record* record_;
+
+    public:
+        HazardPointer()
+            : record_{Detail::record_cache().pop()}
+        {
+        }
+
+        HazardPointer(const HazardPointer&) = delete;
+        HazardPointer& operator=(const HazardPointer&) = delete;
+
+        ~HazardPointer()
+        {
+            reset_protection();
+            Detail::record_cache().push(record_);
+        }
+
+        // returned pointer stays valid until the protection is reset (or changed)
+        template <typename T>
+        T* protect(const std::atomic<T*>& src) noexcept
+        {
+            T* ptr = src.load(std::memory_order_relaxed);
+            while (true)
+            {
+                record_->ptr.store(ptr, std::memory_order_seq_cst);
+
+                T* current = src.load(std::memory_order_seq_cst); // still linked after publication?
+                if (current == ptr)
+                    return ptr;
+
+                ptr = current;
+            }
+        }
+
+        void reset_protection() noexcept
+        {
+            record_->ptr.store(nullptr, std::memory_order_release);
+        }
+    };
+
+    template <typename T>
+    void retire(T* ptr)
+    {
+        Domain::global().retire(ptr);
+    }
+
+    inline std::size_t reclaim()
+    {
+        return Domain::global().reclaim();
+    }
+
+    // calls f with the object pointed by link (or nullptr) - the object can't be deleted during the call
+    template <typename T, typename F>
+    decltype(auto) guarded_read(const std::atomic<T*>& link, F&& f)
+    {
+        HazardPointer hp;
+        return std::forward<F>(f)(hp.protect(link));
+    }
+} // namespace Hazard
+
+#endif
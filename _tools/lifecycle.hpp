@@ -0,0 +1,120 @@
+#ifndef LIFECYCLE_HPP
+#define LIFECYCLE_HPP
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////
+// Lifecycle - counts constructions, copies, moves & destructions per type
+//
+// A class opts in with a member:
+//
+//    [[no_unique_address]] Lifecycle::Counter<Array> lifecycle_;
+//
+// Defaulted special functions count automatically. User-provided copy/move
+// constructors & assignments must pass the member on explicitly.
+// Counters are kept per thread (like AllocTracker).
+
+namespace Lifecycle
+{
+    struct Counters
+    {
+        std::size_t constructed; // constructions other than copy/move
+        std::size_t copy_constructed;
+        std::size_t move_constructed;
+        std::size_t copy_assigned;
+        std::size_t move_assigned;
+        std::size_t destroyed;
+
+        std::size_t copies() const noexcept
+        {
+            return copy_constructed + copy_assigned;
+        }
+
+        std::size_t moves() const noexcept
+        {
+            return move_constructed + move_assigned;
+        }
+    };
+
+    template <typename T>
+    Counters& counters() noexcept
+    {
+        thread_local Counters counters_of_t{};
+        return counters_of_t;
+    }
+
+    template <typename T>
+    class Counter
+    {
+    public:
+        Counter() noexcept
+        {
+            ++counters<T>().constructed;
+        }
+
+        Counter(const Counter&) noexcept
+        {
+            ++counters<T>().copy_constructed;
+        }
+
+        Counter(Counter&&) noexcept
+        {
+            ++counters<T>().move_constructed;
+        }
+
+        Counter& operator=(const Counter&) noexcept
+        {
+            ++counters<T>().copy_assigned;
+            return *this;
+        }
+
+        Counter& operator=(Counter&&) noexcept
+        {
+            ++counters<T>().move_assigned;
+            return *this;
+        }
+
+        ~Counter()
+        {
+            ++counters<T>().destroyed;
+        }
+    };
+
+    // snapshot of counters for T - reports events that happened during its lifetime
+    template <typename T>
+    class Scope
+    {
+        Counters start_;
+
+    public:
+        Scope() noexcept
+            : start_{counters<T>()}
+        {
+        }
+
+        Counters stats() const noexcept
+        {
+            const Counters& now = counters<T>();
+
+            return Counters{
+                now.constructed - start_.constructed,
+                now.copy_constructed - start_.copy_constructed,
+                now.move_constructed - start_.move_constructed,
+                now.copy_assigned - start_.copy_assigned,
+                now.move_assigned - start_.move_assigned,
+                now.destroyed - start_.destroyed};
+        }
+
+        std::size_t copies() const noexcept
+        {
+            return stats().copies();
+        }
+
+        std::size_t moves() const noexcept
+        {
+            return stats().moves();
+        }
+    };
+} // namespace Lifecycle
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// Pool - size-class allocator for small objects, e.g. fused control block + object
+// created by std::allocate_shared or a coroutine frame
+//
+// auto g = Pool::make_pooled<Gadget>(1, "ipad");
+//
+// - size classes: 16, 32, ..., 256 bytes - larger requests go to operator new
+// - each thread caches free blocks - no locking on the fast path
+// - blocks are carved from 64 KB chunks, freed blocks are reused (never returned to OS)
+
+namespace Pool
+{
+    constexpr std::size_t granularity = 16;
+    constexpr std::size_t max_pooled_size = 256;
+    constexpr std::size_t class_count = max_pooled_size / granularity;
+    constexpr std::size_t chunk_size = 64 * 1024;
+    constexpr std::size_t batch_size = 32; // blocks moved between a thread cache & the central pool at once
+
+    struct Stats
+    {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t large_allocations = 0; // served by operator new
+        std::size_t refills = 0;           // batches taken from the central pool
+        std::size_t flushes = 0;           // batches returned to the central pool
+    };
+
+    namespace Detail
+    {
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        inline std::size_t size_class_of(std::size_t bytes)
+        {
+            return bytes == 0 ? 0 : (bytes - 1) / granularity;
+        }
+
+        inline std::size_t block_size_of(std::size_t size_class)
+        {
+            return (size_class + 1) * granularity;
+        }
+
+        class CentralPool
+        {
+            struct alignas(64) SizeClass
+            {
+                std::mutex mtx;
+                FreeBlock* free_list = nullptr;
+            };
+
+            std::array<SizeClass, class_count> classes_;
+            std::atomic<std::size_t> reserved_bytes_{0};
+
+        public:
+            // returns a list of count blocks
+            FreeBlock* take(std::size_t size_class, std::size_t count)
+            {
+                SizeClass& sc = classes_[size_class];
+                std::lock_guard lk{sc.mtx};
+
+                FreeBlock* head = nullptr;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (!sc.free_list)
+                        sc.free_list = carve_chunk(size_class);
+
+                    FreeBlock* block = sc.free_list;
+                    sc.free_list = block->next;
+                    block->next = head;
+                    head = block;
+                }
+
+                return head;
+            }
+
+            void give(std::size_t size_class, FreeBlock* first, FreeBlock* last)
+            {
+                SizeClass& sc = classes_[size_class];
+                std::lock_guard lk{sc.mtx};
+
+                last->next = sc.free_list;
+                sc.free_list = first;
+            }
+
+            std::size_t reserved_bytes() const
+            {
+                return reserved_bytes_.load(std::memory_order_relaxed);
+            }
+
+        private:
+            FreeBlock* carve_chunk(std::size_t size_class)
+            {
+                const std::size_t block_size = block_size_of(size_class);
+                const std::size_t block_count = chunk_size / block_size;
+
+                std::byte* chunk = static_cast<std::byte*>(::operator new(chunk_size));
+                reserved_bytes_.fetch_add(chunk_size, std::memory_order_relaxed);
+
+                FreeBlock* head = nullptr;
+                for (std::size_t i = block_count; i > 0; --i)
+                    head = ::new (chunk + (i - 1) * block_size) FreeBlock{head};
+
+                return head;
+            }
+        };
+
+        // never destroyed - pooled objects may be released during static destruction
+        inline CentralPool& central_pool()
+        {
+            static CentralPool* pool = new CentralPool;
+            return *pool;
+        }
+
+        class ThreadCache
+        {
+            std::array<FreeBlock*, class_count> free_lists_{};
+            std::array<std::size_t, class_count> counts_{};
+
+        public:
+            Stats stats;
+
+            ~ThreadCache();
+
+            void* pop(std::size_t size_class)
+            {
+                if (!free_lists_[size_class])
+                {
+                    free_lists_[size_class] = central_pool().take(size_class, batch_size);
+                    counts_[size_class] = batch_size;
+                    ++stats.refills;
+                }
+
+                FreeBlock* block = free_lists_[size_class];
+                free_lists_[size_class] = block->next;
+                --counts_[size_class];
+
+                return block;
+            }
+
+            void push(std::size_t size_class, void* ptr)
+            {
+                FreeBlock* block = ::new (ptr) FreeBlock{free_lists_[size_class]};
+                free_lists_[size_class] = block;
+
+                if (++counts_[size_class] >= 2 * batch_size)
+                    flush(size_class, batch_size);
+            }
+
+        private:
+            void flush(std::size_t size_class, std::size_t count)
+            {
+                FreeBlock* first = free_lists_[size_class];
+                FreeBlock* last = first;
+                for (std::size_t i = 1; i < count; ++i)
+                    last = last->next;
+
+                free_lists_[size_class] = last->next;
+                counts_[size_class] -= count;
+                central_pool().give(size_class, first, last);
+                ++stats.flushes;
+            }
+        };
+
+        // trivially destructible - still readable when the cache of an exiting thread is gone
+        inline thread_local bool thread_cache_destroyed = false;
+
+        inline ThreadCache::~ThreadCache()
+        {
+            for (std::size_t size_class = 0; size_class < class_count; ++size_class)
+            {
+                if (counts_[size_class] > 0)
+                    flush(size_class, counts_[size_class]);
+            }
+
+            thread_cache_destroyed = true;
+        }
+
+        inline ThreadCache& thread_cache()
+        {
+            thread_local ThreadCache cache;
+            return cache;
+        }
+    } // namespace Detail
+
+    inline void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (bytes > max_pooled_size || alignment > granularity)
+        {
+            if (!Detail::thread_cache_destroyed)
+                ++Detail::thread_cache().stats.large_allocations;
+
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+
+        const std::size_t size_class = Detail::size_class_of(bytes);
+
+        if (Detail::thread_cache_destroyed)
+            return Detail::central_pool().take(size_class, 1);
+
+        Detail::ThreadCache& cache = Detail::thread_cache();
+        ++cache.stats.allocations;
+
+        return cache.pop(size_class);
+    }
+
+    // bytes & alignment must match the allocation
+    inline void deallocate(void* ptr, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (bytes > max_pooled_size || alignment > granularity)
+        {
+            ::operator delete(ptr, std::align_val_t{alignment});
+            return;
+        }
+
+        // a block from an exiting thread goes straight to the central pool
+        if (Detail::thread_cache_destroyed)
+        {
+            auto* block = ::new (ptr) Detail::FreeBlock{nullptr};
+            Detail::central_pool().give(Detail::size_class_of(bytes), block, block);
+            return;
+        }
+
+        Detail::ThreadCache& cache = Detail::thread_cache();
+        ++cache.stats.deallocations;
+
+        cache.push(Detail::size_class_of(bytes), ptr);
+    }
+
+    inline const Stats& thread_stats()
+    {
+        return Detail::thread_cache().stats;
+    }
+
+    // memory taken from operator new for chunks - by all threads
+    inline std::size_t reserved_bytes()
+    {
+        return Detail::central_pool().reserved_bytes();
+    }
+
+    template <typename T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(Pool::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept
+        {
+            Pool::deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    // control block & object in one pooled block
+    template <typename T, typename... TArgs>
+    std::shared_ptr<T> make_pooled(TArgs&&... args)
+    {
+        return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<TArgs>(args)...);
+    }
+} // namespace Pool
+
+#endif
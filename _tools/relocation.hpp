@@ -0,0 +1,322 @@
+#ifndef RELOCATION_HPP
+#define RELOCATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// Relocation - move-construct + destroy of the source done as one memcpy
+//
+// A type opts in by specializing is_trivially_relocatable:
+//
+//    template <>
+//    struct Relocation::is_trivially_relocatable<Array> : std::true_type {};
+//
+// Don't opt in types holding pointers into themselves (e.g. libstdc++
+// std::string with SSO, std::list) - their bytes can't be moved to other address.
+
+namespace Relocation
+{
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {
+    };
+
+    template <typename T>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // unique_ptr with the default deleter is a single pointer
+    template <typename T>
+    struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type
+    {
+    };
+
+    // moves [first, last) to uninitialized dest & ends lifetime of the source objects
+    // if a copy constructor throws, the source range is left intact (like move_if_noexcept)
+    template <typename T>
+    void relocate(T* first, T* last, T* dest) noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            if (first != last)
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        {
+            std::uninitialized_move(first, last, dest);
+            std::destroy(first, last);
+        }
+        else
+        {
+            std::uninitialized_copy(first, last, dest);
+            std::destroy(first, last);
+        }
+    }
+
+    // contiguous container that grows & erases by relocation when T allows it
+    template <typename T>
+    class Vector
+    {
+        T* items_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t capacity_ = 0;
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        Vector() = default;
+
+        // delegation - if a copy throws, the destructor releases the items built so far & the buffer
+        Vector(std::initializer_list<T> il)
+            : Vector{}
+        {
+            reserve(il.size());
+            for (const auto& item : il)
+                push_back(item);
+        }
+
+        Vector(const Vector& source)
+            : Vector{}
+        {
+            reserve(source.size_);
+            std::uninitialized_copy(source.begin(), source.end(), items_);
+            size_ = source.size_;
+        }
+
+        Vector& operator=(const Vector& source)
+        {
+            Vector temp(source);
+            swap(temp);
+
+            return *this;
+        }
+
+        Vector(Vector&& source) noexcept
+            : items_{std::exchange(source.items_, nullptr)}
+            , size_{std::exchange(source.size_, 0)}
+            , capacity_{std::exchange(source.capacity_, 0)}
+        {
+        }
+
+        Vector& operator=(Vector&& source) noexcept
+        {
+            Vector temp(std::move(source));
+            swap(temp);
+
+            return *this;
+        }
+
+        ~Vector()
+        {
+            clear();
+            deallocate(items_);
+        }
+
+        void swap(Vector& other) noexcept
+        {
+            std::swap(items_, other.items_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        std::size_t capacity() const
+        {
+            return capacity_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        iterator begin()
+        {
+            return items_;
+        }
+
+        const_iterator begin() const
+        {
+            return items_;
+        }
+
+        iterator end()
+        {
+            return items_ + size_;
+        }
+
+        const_iterator end() const
+        {
+            return items_ + size_;
+        }
+
+        T& operator[](std::size_t index)
+        {
+            return items_[index];
+        }
+
+        const T& operator[](std::size_t index) const
+        {
+            return items_[index];
+        }
+
+        T& at(std::size_t index)
+        {
+            if (index >= size_)
+                throw std::out_of_range("Index out of bounds");
+
+            return items_[index];
+        }
+
+        const T& at(std::size_t index) const
+        {
+            if (index >= size_)
+                throw std::out_of_range("Index out of bounds");
+
+            return items_[index];
+        }
+
+        T& back()
+        {
+            return items_[size_ - 1];
+        }
+
+        void reserve(std::size_t new_capacity)
+        {
+            if (new_capacity <= capacity_)
+                return;
+
+            T* new_items = allocate(new_capacity);
+
+            try
+            {
+                relocate(items_, items_ + size_, new_items);
+            }
+            catch (...)
+            {
+                deallocate(new_items);
+                throw;
+            }
+
+            deallocate(items_);
+
+            items_ = new_items;
+            capacity_ = new_capacity;
+        }
+
+        template <typename... TArgs>
+        T& emplace_back(TArgs&&... args)
+        {
+            if (size_ < capacity_)
+            {
+                T& item = *std::construct_at(items_ + size_, std::forward<TArgs>(args)...);
+                ++size_; // only after the item is constructed
+                return item;
+            }
+
+            // new item is constructed first - args may refer to items of this vector
+            const std::size_t new_capacity = std::max<std::size_t>(2 * capacity_, 4);
+            T* new_items = allocate(new_capacity);
+
+            try
+            {
+                std::construct_at(new_items + size_, std::forward<TArgs>(args)...);
+            }
+            catch (...)
+            {
+                deallocate(new_items);
+                throw;
+            }
+
+            try
+            {
+                relocate(items_, items_ + size_, new_items);
+            }
+            catch (...)
+            {
+                std::destroy_at(new_items + size_);
+                deallocate(new_items);
+                throw;
+            }
+
+            deallocate(items_);
+
+            items_ = new_items;
+            capacity_ = new_capacity;
+
+            return items_[size_++];
+        }
+
+        void push_back(const T& item)
+        {
+            emplace_back(item);
+        }
+
+        void push_back(T&& item)
+        {
+            emplace_back(std::move(item));
+        }
+
+        void pop_back()
+        {
+            std::destroy_at(items_ + --size_);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            T* target = items_ + (pos - items_);
+
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                std::destroy_at(target);
+                relocate(target + 1, end(), target); // memmove of the tail
+                --size_;
+            }
+            else
+            {
+                std::move(target + 1, end(), target);
+                pop_back();
+            }
+
+            return target;
+        }
+
+        void clear()
+        {
+            std::destroy(begin(), end());
+            size_ = 0;
+        }
+
+    private:
+        static T* allocate(std::size_t capacity)
+        {
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t{alignof(T)}));
+            else
+                return static_cast<T*>(::operator new(capacity * sizeof(T)));
+        }
+
+        static void deallocate(T* items)
+        {
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(items, std::align_val_t{alignof(T)});
+            else
+                ::operator delete(items);
+        }
+    };
+} // namespace Relocation
+
+#endif
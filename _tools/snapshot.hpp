@@ -0,0 +1,142 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "hazard_pointers.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Snapshot<T> - RCU-style holder of read-mostly state
+//
+// - readers see an immutable version of T - no locks, no writes to shared memory
+// - writers copy the current version, modify the copy & publish it atomically
+// - replaced versions are reclaimed with hazard pointers, after the last reader
+//
+// Snapshot<Config> config{...};
+// config.read([](const Config& cfg) { use(cfg.timeout); });
+// config.update([](Config& cfg) { cfg.timeout = 100; });
+
+namespace Concurrency
+{
+    template <typename T>
+    class Snapshot
+    {
+        std::atomic<const T*> current_;
+        std::atomic<std::size_t> version_{0};
+
+        std::mutex mtx_writers_;
+        std::vector<std::function<void(T&)>> pending_updates_;
+
+    public:
+        template <typename... TArgs>
+        explicit Snapshot(TArgs&&... args)
+            : current_{new T(std::forward<TArgs>(args)...)}
+        {
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        // no readers may be left
+        ~Snapshot()
+        {
+            delete current_.load();
+        }
+
+        // f gets a consistent view - valid only during the call
+        template <typename F>
+        decltype(auto) read(F&& f) const
+        {
+            return Hazard::guarded_read(current_, [&f](const T* value) -> decltype(auto) {
+                return std::forward<F>(f)(*value);
+            });
+        }
+
+        T load() const
+        {
+            return read([](const T& value) { return value; });
+        }
+
+        // number of published versions
+        std::size_t version() const
+        {
+            return version_.load(std::memory_order_acquire);
+        }
+
+        void store(T value)
+        {
+            std::lock_guard lk{mtx_writers_};
+            publish(new T(std::move(value)));
+        }
+
+        // copy-on-write: f modifies a copy of the current version
+        template <typename F>
+        void update(F&& f)
+        {
+            std::lock_guard lk{mtx_writers_};
+
+            T* copy = new T(*current_.load(std::memory_order_acquire));
+            try
+            {
+                std::forward<F>(f)(*copy);
+            }
+            catch (...)
+            {
+                delete copy;
+                throw;
+            }
+
+            publish(copy);
+        }
+
+        // batching: queued updates are applied to a single copy by flush()
+        void defer_update(std::function<void(T&)> f)
+        {
+            std::lock_guard lk{mtx_writers_};
+            pending_updates_.push_back(std::move(f));
+        }
+
+        // returns number of applied updates - if any update throws, the whole batch is dropped
+        std::size_t flush()
+        {
+            std::lock_guard lk{mtx_writers_};
+
+            if (pending_updates_.empty())
+                return 0;
+
+            std::vector<std::function<void(T&)>> updates = std::move(pending_updates_);
+            pending_updates_.clear();
+
+            T* copy = new T(*current_.load(std::memory_order_acquire));
+            try
+            {
+                for (auto& update : updates)
+                    update(*copy);
+            }
+            catch (...)
+            {
+                delete copy;
+                throw;
+            }
+
+            publish(copy);
+
+            return updates.size();
+        }
+
+    private:
+        void publish(const T* value)
+        {
+            const T* old = current_.exchange(value, std::memory_order_acq_rel);
+            version_.fetch_add(1, std::memory_order_release);
+            Hazard::retire(const_cast<T*>(old));
+        }
+    };
+} // namespace Concurrency
+
+#endif
@@ -2,6 +2,8 @@
 #define ARRAY_HPP
 
 #include <iostream>
+#include <lifecycle.hpp>
+#include <relocation.hpp>
 
 class Array
 {
@@ -16,6 +18,7 @@ public:
     Array(const Array& source)
         : size_{source.size()}
         , items_{new int[source.size()]}
+        , lifecycle_{source.lifecycle_}
     {
         std::copy(source.begin(), source.end(), items_);
 
@@ -48,6 +51,7 @@ public:
     Array(Array&& source) noexcept
         : size_{source.size_}
         , items_{source.items_}
+        , lifecycle_{std::move(source.lifecycle_)}
     {
         source.size_ = 0; // extra safety
         source.items_ = nullptr;
@@ -159,6 +163,7 @@ public:
 private:
     size_t size_;
     int* items_;
+    [[no_unique_address]] Lifecycle::Counter<Array> lifecycle_;
 
     void print() const
     {
@@ -171,6 +176,12 @@ private:
     }
 };
 
+// Array owns only a pointer to the heap - its bytes can be moved with memcpy
+template <>
+struct Relocation::is_trivially_relocatable<Array> : std::true_type
+{
+};
+
 namespace Templates
 {
     template <typename T>
@@ -1,10 +1,13 @@
 #include "utils.hpp"
 
 #include <algorithm>
+#include <alloc_tracker.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
+#include <lifecycle.hpp>
 #include <list>
 #include <memory>
+#include <relocation.hpp>
 #include <string>
 #include <vector>
 
@@ -260,6 +263,127 @@ TEST_CASE("return by value")
     }
 }
 
+TEST_CASE("return by value - allocation budget")
+{
+    SECTION("create_squares allocates once")
+    {
+        AllocTracker::Scope alloc_scope;
+
+        Array squares = create_squares(100);
+
+        CHECK(alloc_scope.allocations() == 1);
+        CHECK(alloc_scope.bytes_allocated() == 100 * sizeof(int));
+    }
+
+    SECTION("move of Array does not allocate")
+    {
+        Array squares = create_squares(100);
+
+        AllocTracker::Scope alloc_scope;
+
+        Array target = std::move(squares);
+
+        CHECK(alloc_scope.allocations() == 0);
+    }
+
+    SECTION("memory is released")
+    {
+        AllocTracker::Scope alloc_scope;
+
+        {
+            Array squares = create_squares(100);
+        }
+
+        auto stats = alloc_scope.stats();
+        CHECK(stats.deallocations == 1);
+        CHECK(stats.live_bytes == 0);
+        CHECK(stats.peak_live_bytes == 100 * sizeof(int));
+        CHECK(stats.size_histogram[AllocTracker::bucket_of(100 * sizeof(int))] == 1);
+    }
+}
+
+TEST_CASE("return by value - copy/move budget")
+{
+    SECTION("create_squares never copies")
+    {
+        Lifecycle::Scope<Array> lifecycle_scope;
+
+        Array squares = create_squares(5);
+
+        CHECK(lifecycle_scope.stats().constructed == 1);
+        CHECK(lifecycle_scope.copies() == 0);
+    }
+
+    SECTION("vector<Array> growth moves items")
+    {
+        std::vector<Array> data;
+        data.push_back(Array{665, 667});
+        data.push_back(Array{1115, 5667});
+
+        Lifecycle::Scope<Array> lifecycle_scope;
+
+        data.push_back(create_squares(5)); // reallocation - move_if_noexcept
+
+        auto stats = lifecycle_scope.stats();
+        CHECK(stats.copies() == 0);
+        CHECK(stats.move_constructed == 3);
+    }
+
+    SECTION("vector<Gadget> growth moves items")
+    {
+        std::vector<Gadget> gadgets;
+        gadgets.emplace_back(1, "ipad");
+        gadgets.emplace_back(2, "smartwatch");
+
+        Lifecycle::Scope<Gadget> lifecycle_scope;
+
+        gadgets.emplace_back(3, "phone");
+
+        CHECK(lifecycle_scope.copies() == 0);
+        CHECK(lifecycle_scope.stats().move_constructed == 2);
+    }
+}
+
+TEST_CASE("relocation of Array")
+{
+    static_assert(Relocation::is_trivially_relocatable_v<Array>);
+
+    Relocation::Vector<Array> data;
+    data.push_back(create_squares(3));
+    data.push_back(create_squares(3, 2));
+    data.push_back(create_squares(3, 3));
+    data.push_back(create_squares(3, 4));
+
+    SECTION("growth is memcpy - no moves, no destructions")
+    {
+        Lifecycle::Scope<Array> lifecycle_scope;
+
+        data.push_back(create_squares(3, 5)); // reallocation
+
+        auto stats = lifecycle_scope.stats();
+        CHECK(stats.copies() == 0);
+        CHECK(stats.move_constructed == 1); // only the argument of push_back
+        CHECK(stats.destroyed == 1);
+        CHECK(data.size() == 5);
+        CHECK(data[0] == Array{1, 4, 9});
+        CHECK(data[4] == Array{25, 36, 49});
+    }
+
+    SECTION("erase in the middle")
+    {
+        Lifecycle::Scope<Array> lifecycle_scope;
+
+        data.erase(data.begin() + 1);
+
+        auto stats = lifecycle_scope.stats();
+        CHECK(stats.moves() == 0);
+        CHECK(stats.destroyed == 1);
+        CHECK(data.size() == 3);
+        CHECK(data[1] == Array{9, 16, 25});
+        CHECK(data[2] == Array{16, 25, 36});
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // Rule of zero
 
@@ -0,0 +1,207 @@
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include "task_future.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// async - cancellable replacement of std::async running on a pool
+//
+// auto f = Executors::async(pool, [](std::stop_token stop, int x) {   // or async(f, args...) on shared_pool()
+//     while (!stop.stop_requested()) { ... }
+//     return x;
+// }, 42);
+//
+// if (f.wait_for(100ms) == std::future_status::timeout)   // a timeout requests stop
+//     ...
+//
+// - concurrency is capped by the pool's workers - launching a job never starts a thread
+// - a job taking std::stop_token as its first parameter is cancelled cooperatively
+//   (request_stop(), a timed out wait_for() or a stop of the token passed to async);
+//   a job cancelled before it starts isn't run - get() throws OperationCancelled
+// - unlike std::future of std::async, a discarded CancellableFuture doesn't block
+
+namespace Executors
+{
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled()
+            : std::runtime_error{"Operation cancelled"}
+        {
+        }
+    };
+
+    template <typename T>
+    class CancellableFuture
+    {
+    public:
+        using value_type = T;
+
+        CancellableFuture(TaskFuture<T> future, std::stop_source stop) noexcept
+            : future_{std::move(future)}
+            , stop_{std::move(stop)}
+        {
+        }
+
+        bool is_ready() const noexcept
+        {
+            return future_.is_ready();
+        }
+
+        void wait() const noexcept
+        {
+            future_.wait();
+        }
+
+        // requests stop of the job if it isn't ready before the timeout
+        template <typename Rep, typename Period>
+        std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout)
+        {
+            return wait_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        template <typename Clock, typename Duration>
+        std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& deadline)
+        {
+            const std::future_status status = future_.wait_until(deadline);
+            if (status == std::future_status::timeout)
+                stop_.request_stop();
+            return status;
+        }
+
+        decltype(auto) get() const
+        {
+            return future_.get();
+        }
+
+        bool request_stop() noexcept
+        {
+            return stop_.request_stop();
+        }
+
+        std::stop_token get_stop_token() const noexcept
+        {
+            return stop_.get_token();
+        }
+
+        const TaskFuture<T>& future() const noexcept
+        {
+            return future_;
+        }
+
+    private:
+        TaskFuture<T> future_;
+        std::stop_source stop_;
+    };
+
+    namespace Detail
+    {
+        template <typename F, typename... TArgs>
+        struct AsyncResult
+        {
+            static constexpr bool takes_stop_token = std::is_invocable_v<F, std::stop_token, TArgs...>;
+            using type = typename std::conditional_t<takes_stop_token, std::invoke_result<F, std::stop_token, TArgs...>, std::invoke_result<F, TArgs...>>::type;
+        };
+
+        struct StopForwarder
+        {
+            std::stop_source target;
+
+            void operator()() const noexcept
+            {
+                target.request_stop();
+            }
+        };
+
+        template <Executor E, typename F, typename... TArgs>
+        auto launch(E& executor, std::stop_token external_stop, F&& f, TArgs&&... args)
+        {
+            using Result = AsyncResult<std::decay_t<F>, std::decay_t<TArgs>...>;
+            using R = typename Result::type;
+
+            auto state = std::make_shared<SharedState<R>>();
+            std::stop_source stop;
+            CancellableFuture<R> future{TaskFuture<R>{state}, stop};
+
+            std::shared_ptr<std::stop_callback<StopForwarder>> link; // alive while the job is pending
+            if (external_stop.stop_possible())
+                link = std::make_shared<std::stop_callback<StopForwarder>>(std::move(external_stop), StopForwarder{stop});
+
+            executor.post([state = std::move(state), stop = std::move(stop), link = std::move(link), f = std::forward<F>(f),
+                              args = std::make_tuple(std::forward<TArgs>(args)...)]() mutable {
+                if (stop.stop_requested())
+                {
+                    state->set_exception(std::make_exception_ptr(OperationCancelled{}));
+                    return;
+                }
+
+                auto call = [&]() -> R {
+                    if constexpr (Result::takes_stop_token)
+                        return std::apply(std::move(f), std::tuple_cat(std::make_tuple(stop.get_token()), std::move(args)));
+                    else
+                        return std::apply(std::move(f), std::move(args));
+                };
+
+                try
+                {
+                    fulfil(*state, call);
+                }
+                catch (...)
+                {
+                    state->set_exception(std::current_exception());
+                }
+            });
+
+            return future;
+        }
+    } // namespace Detail
+
+    // pool shared by async calls without an executor - one worker per hardware thread
+    inline WorkStealingPool& shared_pool()
+    {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    template <Executor E, typename F, typename... TArgs>
+        requires(!std::same_as<std::remove_cvref_t<F>, std::stop_token>)
+    auto async(E& executor, F&& f, TArgs&&... args)
+    {
+        return Detail::launch(executor, std::stop_token{}, std::forward<F>(f), std::forward<TArgs>(args)...);
+    }
+
+    // stop of the token is forwarded to the job
+    template <Executor E, typename F, typename... TArgs>
+    auto async(E& executor, std::stop_token stop, F&& f, TArgs&&... args)
+    {
+        return Detail::launch(executor, std::move(stop), std::forward<F>(f), std::forward<TArgs>(args)...);
+    }
+
+    template <typename F, typename... TArgs>
+        requires(!Executor<std::remove_cvref_t<F>> && !std::same_as<std::remove_cvref_t<F>, std::stop_token>)
+    auto async(F&& f, TArgs&&... args)
+    {
+        return Detail::launch(shared_pool(), std::stop_token{}, std::forward<F>(f), std::forward<TArgs>(args)...);
+    }
+
+    template <typename F, typename... TArgs>
+    auto async(std::stop_token stop, F&& f, TArgs&&... args)
+    {
+        return Detail::launch(shared_pool(), std::move(stop), std::forward<F>(f), std::forward<TArgs>(args)...);
+    }
+} // namespace Executors
+
+#endif
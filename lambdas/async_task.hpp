@@ -0,0 +1,312 @@
+#ifndef ASYNC_TASK_HPP
+#define ASYNC_TASK_HPP
+
+#include "task_future.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <pool_allocator.hpp>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// AsyncTask - lazy coroutine task for executors (TaskQueue, WorkStealingPool)
+//
+// AsyncTask<int> load(TaskQueue& q)
+// {
+//     co_await schedule_on(q);             // continues as a task of q
+//     int value = co_await parse(q);       // starts the child & resumes when it completes
+//     co_return value * 2;
+// }
+//
+// TaskFuture<int> f = start(load(q));     // runs until the first suspension
+// q.run();
+//
+// - a task starts when it's awaited (or started) - a task completing synchronously lets the awaiting
+//   coroutine continue without suspending (await_suspend returns false), so long chains of synchronous
+//   completions don't grow the stack regardless of the optimizer; a task completing later resumes it
+// - coroutine frames are allocated from the size-class pool (Pool::allocate)
+// - an exception escaping a task is rethrown by co_await (or stored in the future)
+
+namespace Executors
+{
+    template <typename T = void>
+    class AsyncTask;
+
+    namespace Detail
+    {
+        struct PooledFrame
+        {
+            static void* operator new(std::size_t size)
+            {
+                return Pool::allocate(size);
+            }
+
+            static void operator delete(void* ptr, std::size_t size) noexcept
+            {
+                Pool::deallocate(ptr, size);
+            }
+        };
+
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> completed) noexcept
+            {
+                auto& promise = completed.promise();
+                if (promise.continuation && promise.arrive())
+                    return promise.continuation;
+                return std::noop_coroutine(); // the awaiting coroutine hasn't suspended - it continues itself
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        struct PromiseBase : PooledFrame
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            std::atomic<bool> arrived{false};
+
+            // called by the awaiter when the started task returns control & by the final suspension -
+            // returns true for the second one, which resumes the awaiting coroutine
+            bool arrive() noexcept
+            {
+                return arrived.exchange(true, std::memory_order_acq_rel);
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception() noexcept
+            {
+                exception = std::current_exception();
+            }
+
+            void rethrow_if_failed() const
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase
+        {
+            std::optional<T> value;
+
+            AsyncTask<T> get_return_object() noexcept
+            {
+                return AsyncTask<T>{std::coroutine_handle<Promise>::from_promise(*this)};
+            }
+
+            template <typename U>
+            void return_value(U&& result)
+            {
+                value.emplace(std::forward<U>(result));
+            }
+
+            T result()
+            {
+                rethrow_if_failed();
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase
+        {
+            AsyncTask<void> get_return_object() noexcept;
+
+            void return_void() noexcept
+            {
+            }
+
+            void result() const
+            {
+                rethrow_if_failed();
+            }
+        };
+
+        // eager coroutine destroying its frame on completion
+        struct Detached
+        {
+            struct promise_type : PooledFrame
+            {
+                Detached get_return_object() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+    } // namespace Detail
+
+    template <typename T>
+    class [[nodiscard]] AsyncTask
+    {
+    public:
+        using promise_type = Detail::Promise<T>;
+
+        AsyncTask(const AsyncTask&) = delete;
+        AsyncTask& operator=(const AsyncTask&) = delete;
+
+        AsyncTask(AsyncTask&& other) noexcept
+            : handle_{std::exchange(other.handle_, nullptr)}
+        {
+        }
+
+        AsyncTask& operator=(AsyncTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~AsyncTask()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        // starts the task - the awaiting coroutine is resumed when the task completes
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> task;
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                // the task runs until its first suspension - false if it completed meanwhile
+                bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    task.promise().continuation = awaiting;
+                    task.resume();
+                    return !task.promise().arrive();
+                }
+
+                decltype(auto) await_resume()
+                {
+                    return task.promise().result();
+                }
+            };
+
+            return Awaiter{handle_};
+        }
+
+    private:
+        friend promise_type;
+
+        explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept
+            : handle_{handle}
+        {
+        }
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    inline AsyncTask<void> Detail::Promise<void>::get_return_object() noexcept
+    {
+        return AsyncTask<void>{std::coroutine_handle<Promise>::from_promise(*this)};
+    }
+
+    // resumes the awaiting coroutine as a task of the executor
+    template <Executor E>
+    auto schedule_on(E& executor) noexcept
+    {
+        struct Awaiter
+        {
+            E& executor;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                executor.post([awaiting] { awaiting.resume(); });
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        return Awaiter{executor};
+    }
+
+    // runs the task on the calling thread until its first suspension - the result is set in the future
+    template <typename T>
+    TaskFuture<T> start(AsyncTask<T> task)
+    {
+        auto state = std::make_shared<Detail::SharedState<T>>();
+        TaskFuture<T> future{state};
+
+        [](AsyncTask<T> task, std::shared_ptr<Detail::SharedState<T>> state) -> Detail::Detached {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    co_await std::move(task);
+                    state->set_value();
+                }
+                else
+                    state->set_value(co_await std::move(task));
+            }
+            catch (...)
+            {
+                state->set_exception(std::current_exception());
+            }
+        }(std::move(task), std::move(state));
+
+        return future;
+    }
+} // namespace Executors
+
+#endif
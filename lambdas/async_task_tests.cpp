@@ -0,0 +1,280 @@
+#include "async_task.hpp"
+#include "task_queue.hpp"
+#include "thread_pool.hpp"
+
+#include <alloc_tracker.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Executors::AsyncTask;
+using Executors::schedule_on;
+
+namespace
+{
+    AsyncTask<int> answer()
+    {
+        co_return 42;
+    }
+
+    AsyncTask<std::string> describe(TaskQueue& q, std::vector<std::string>& log)
+    {
+        log.push_back("before schedule_on");
+        co_await schedule_on(q);
+        log.push_back("on queue");
+
+        const int value = co_await answer();
+        co_return "answer: " + std::to_string(value);
+    }
+
+    AsyncTask<int> fail()
+    {
+        throw std::runtime_error("Stack overflow");
+        co_return 0;
+    }
+
+    AsyncTask<long long> sum_of_answers(int count)
+    {
+        long long sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += co_await answer(); // completes synchronously - symmetric transfer keeps the stack flat
+        co_return sum;
+    }
+} // namespace
+
+TEST_CASE("AsyncTask")
+{
+    TaskQueue q;
+
+    SECTION("start runs the coroutine until schedule_on - the rest is run by the queue")
+    {
+        std::vector<std::string> log;
+
+        auto f = Executors::start(describe(q, log));
+        CHECK(log == std::vector<std::string>{"before schedule_on"});
+        CHECK_FALSE(f.is_ready());
+
+        q.run();
+
+        CHECK(log == std::vector<std::string>{"before schedule_on", "on queue"});
+        CHECK(f.get() == "answer: 42");
+    }
+
+    SECTION("task is lazy - starts when awaited")
+    {
+        bool started = false;
+        auto task = [](bool& started) -> AsyncTask<> {
+            started = true;
+            co_return;
+        }(started);
+
+        CHECK_FALSE(started);
+
+        Executors::start(std::move(task)).get();
+        CHECK(started);
+    }
+
+    SECTION("exceptions are rethrown by co_await")
+    {
+        auto caller = []() -> AsyncTask<std::string> {
+            try
+            {
+                co_await fail();
+            }
+            catch (const std::runtime_error& e)
+            {
+                co_return e.what();
+            }
+            co_return "";
+        };
+
+        CHECK(Executors::start(caller()).get() == "Stack overflow");
+        CHECK_THROWS_AS(Executors::start(fail()).get(), std::runtime_error);
+    }
+
+    SECTION("move-only results")
+    {
+        auto make = []() -> AsyncTask<std::unique_ptr<int>> { co_return std::make_unique<int>(665); };
+
+        CHECK(*Executors::start(make()).get() == 665);
+    }
+
+    SECTION("long chain of synchronous completions doesn't grow the stack")
+    {
+        const int count = 1'000'000;
+        CHECK(Executors::start(sum_of_answers(count)).get() == 42LL * count);
+    }
+
+    SECTION("coroutine frames are allocated from the pool")
+    {
+        Executors::start(sum_of_answers(100)).get(); // warm-up of the thread cache
+
+        const std::size_t allocations_before = Pool::thread_stats().allocations;
+
+        AllocTracker::Scope scope;
+        auto f = Executors::start(sum_of_answers(100));
+
+        CHECK(Pool::thread_stats().allocations - allocations_before == 102); // sum_of_answers + detached wrapper + 100 x answer
+        CHECK(scope.allocations() == 1);                                     // shared state of the future
+        CHECK(f.get() == 4'200);
+    }
+}
+
+TEST_CASE("AsyncTask - hopping between executors")
+{
+    Executors::WorkStealingPool pool{2};
+    TaskQueue q;
+
+    auto hop = [](Executors::WorkStealingPool& pool, TaskQueue& q) -> AsyncTask<bool> {
+        co_await schedule_on(pool);
+        const auto worker_id = std::this_thread::get_id();
+
+        co_await schedule_on(q);
+        co_return worker_id != std::this_thread::get_id();
+    };
+
+    auto f = Executors::start(hop(pool, q));
+    pool.run();
+    q.run();
+
+    CHECK(f.get() == true);
+}
+
+namespace
+{
+    int parse(int x)
+    {
+        return x * 3 + 1;
+    }
+
+    int transform(int x)
+    {
+        return x % 1'000;
+    }
+
+    AsyncTask<int> process(TaskQueue& q, int x)
+    {
+        co_await schedule_on(q);
+        const int parsed = parse(x);
+        co_await schedule_on(q);
+        const int transformed = transform(parsed);
+        co_await schedule_on(q);
+        co_return transformed + 1;
+    }
+
+    AsyncTask<long long> coroutine_pipeline(TaskQueue& q, int count)
+    {
+        long long sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += co_await process(q, i);
+        co_return sum;
+    }
+
+    // the same pipeline - chained by hand
+    void process(TaskQueue& q, int x, Executors::UniqueFunction<void(int)> done)
+    {
+        q.post([&q, x, done = std::move(done)]() mutable {
+            const int parsed = parse(x);
+            q.post([&q, parsed, done = std::move(done)]() mutable {
+                const int transformed = transform(parsed);
+                q.post([transformed, done = std::move(done)]() mutable { done(transformed + 1); });
+            });
+        });
+    }
+
+    struct CallbackPipeline
+    {
+        TaskQueue& q;
+        int count;
+        long long sum = 0;
+
+        void next(int i)
+        {
+            if (i == count)
+                return;
+
+            process(q, i, [this, i](int result) {
+                sum += result;
+                next(i + 1);
+            });
+        }
+    };
+
+    long long callback_pipeline(TaskQueue& q, int count)
+    {
+        CallbackPipeline pipeline{q, count};
+        pipeline.next(0);
+        q.run();
+        return pipeline.sum;
+    }
+
+    struct Hops
+    {
+        TaskQueue& q;
+        int remaining;
+
+        void operator()()
+        {
+            if (--remaining > 0)
+                q.post([this] { (*this)(); });
+        }
+    };
+} // namespace
+
+TEST_CASE("AsyncTask - pipeline gives the same result as callbacks")
+{
+    TaskQueue q;
+
+    auto f = Executors::start(coroutine_pipeline(q, 1'000));
+    q.run();
+
+    CHECK(f.get() == callback_pipeline(q, 1'000));
+}
+
+TEST_CASE("AsyncTask - benchmark", "[.benchmark]")
+{
+    const int count = 100'000;
+    TaskQueue q;
+
+    BENCHMARK("callback - 100k hops through TaskQueue")
+    {
+        Hops hops{q, count};
+        q.post([&hops] { hops(); });
+        q.run();
+        return hops.remaining;
+    };
+
+    BENCHMARK("coroutine - 100k suspend/resume through TaskQueue")
+    {
+        auto hops = [](TaskQueue& q, int count) -> AsyncTask<int> {
+            for (int i = 0; i < count; ++i)
+                co_await schedule_on(q);
+            co_return count;
+        };
+
+        auto f = Executors::start(hops(q, count));
+        q.run();
+        return f.get();
+    };
+
+    BENCHMARK("coroutine - 100k synchronous co_awaits")
+    {
+        return Executors::start(sum_of_answers(count)).get();
+    };
+
+    BENCHMARK("callback pipeline - 100k items x 3 stages")
+    {
+        return callback_pipeline(q, count);
+    };
+
+    BENCHMARK("coroutine pipeline - 100k items x 3 stages")
+    {
+        auto f = Executors::start(coroutine_pipeline(q, count));
+        q.run();
+        return f.get();
+    };
+}
@@ -0,0 +1,199 @@
+#include "async.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Executors::OperationCancelled;
+
+namespace
+{
+    int calculate(int x)
+    {
+        return x * x;
+    }
+
+    // like calculate() but gives up when stop is requested
+    std::string calculate_slowly(std::stop_token stop, int x)
+    {
+        for (int step = 0; step < 1'000; ++step)
+        {
+            if (stop.stop_requested())
+                return "cancelled at step " + std::to_string(step);
+            std::this_thread::sleep_for(1ms);
+        }
+        return std::to_string(x * x);
+    }
+} // namespace
+
+TEST_CASE("async")
+{
+    Executors::WorkStealingPool pool{2};
+
+    SECTION("arguments are forwarded like std::async")
+    {
+        auto f1 = Executors::async(pool, calculate, 12);
+        auto f2 = Executors::async(pool, [](std::unique_ptr<int> x) { return *x + 1; }, std::make_unique<int>(664));
+
+        CHECK(f1.get() == 144);
+        CHECK(f2.get() == 665);
+    }
+
+    SECTION("exception is stored in the future")
+    {
+        auto f = Executors::async(pool, [] { throw std::runtime_error("Error#13"); });
+        CHECK_THROWS_AS(f.get(), std::runtime_error);
+    }
+
+    SECTION("wait_for - timeout requests stop")
+    {
+        auto f = Executors::async(pool, calculate_slowly, 42);
+
+        CHECK(f.wait_for(10ms) == std::future_status::timeout);
+        CHECK(f.get().starts_with("cancelled at step"));
+    }
+
+    SECTION("wait_for - ready job isn't cancelled")
+    {
+        auto f = Executors::async(pool, calculate, 665);
+
+        CHECK(f.wait_for(1s) == std::future_status::ready);
+        CHECK_FALSE(f.get_stop_token().stop_requested());
+        CHECK(f.get() == 442'225);
+    }
+
+    SECTION("stop of an external token is forwarded to the job")
+    {
+        std::stop_source cancel_all;
+        std::latch started{2};
+        auto job = [&started](std::stop_token stop, int x) {
+            started.count_down();
+            return calculate_slowly(stop, x);
+        };
+
+        auto f1 = Executors::async(pool, cancel_all.get_token(), job, 1);
+        auto f2 = Executors::async(pool, cancel_all.get_token(), job, 2);
+
+        started.wait();
+        cancel_all.request_stop();
+
+        CHECK(f1.get().starts_with("cancelled"));
+        CHECK(f2.get().starts_with("cancelled"));
+    }
+
+    SECTION("job cancelled before it starts isn't run")
+    {
+        Executors::WorkStealingPool single{1};
+        std::latch release{1};
+        bool run = false;
+
+        auto blocker = Executors::async(single, [&release] { release.wait(); });
+        auto f = Executors::async(single, [&run] { run = true; });
+
+        f.request_stop();
+        release.count_down();
+
+        CHECK_THROWS_AS(f.get(), OperationCancelled);
+        CHECK_FALSE(run);
+    }
+
+    SECTION("concurrency is capped by the pool")
+    {
+        std::atomic<int> running = 0;
+        std::atomic<int> max_running = 0;
+
+        std::vector<Executors::CancellableFuture<void>> jobs;
+        for (int i = 0; i < 20; ++i)
+            jobs.push_back(Executors::async(pool, [&] {
+                const int now_running = ++running;
+                int expected = max_running;
+                while (now_running > expected && !max_running.compare_exchange_weak(expected, now_running))
+                    ;
+                std::this_thread::sleep_for(1ms);
+                --running;
+            }));
+
+        for (auto& job : jobs)
+            job.get();
+
+        CHECK(max_running <= 2);
+    }
+}
+
+TEST_CASE("async - 100k jobs on the shared pool don't create 100k threads")
+{
+    std::mutex mtx;
+    std::set<std::thread::id> threads;
+
+    std::vector<Executors::CancellableFuture<int>> jobs;
+    jobs.reserve(100'000);
+    for (int i = 0; i < 100'000; ++i)
+        jobs.push_back(Executors::async(
+            [&](int x) {
+                {
+                    std::lock_guard lk{mtx};
+                    threads.insert(std::this_thread::get_id());
+                }
+                return calculate(x % 1'000);
+            },
+            i));
+
+    long long sum = 0;
+    for (auto& job : jobs)
+        sum += job.get();
+
+    CHECK(sum == 100LL * 332'833'500); // 100 x sum of squares 0..999
+    CHECK(threads.size() <= Executors::shared_pool().worker_count());
+}
+
+TEST_CASE("async - benchmark", "[.benchmark]")
+{
+    Executors::WorkStealingPool& pool = Executors::shared_pool();
+
+    BENCHMARK("std::async - launch & get")
+    {
+        return std::async(std::launch::async, calculate, 665).get();
+    };
+
+    BENCHMARK("Executors::async - launch & get")
+    {
+        return Executors::async(pool, calculate, 665).get();
+    };
+
+    BENCHMARK("std::async - 1000 jobs")
+    {
+        std::vector<std::future<int>> jobs;
+        for (int i = 0; i < 1'000; ++i)
+            jobs.push_back(std::async(std::launch::async, calculate, i));
+
+        long long sum = 0;
+        for (auto& job : jobs)
+            sum += job.get();
+        return sum;
+    };
+
+    BENCHMARK("Executors::async - 1000 jobs")
+    {
+        std::vector<Executors::CancellableFuture<int>> jobs;
+        for (int i = 0; i < 1'000; ++i)
+            jobs.push_back(Executors::async(pool, calculate, i));
+
+        long long sum = 0;
+        for (auto& job : jobs)
+            sum += job.get();
+        return sum;
+    };
+}
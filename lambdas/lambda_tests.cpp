@@ -1,3 +1,4 @@
+#include "task_queue.hpp"
 #include "utils.hpp"
 
 #include <algorithm>
@@ -317,37 +318,6 @@ TEST_CASE("storing callables")
     }
 }
 
-class TaskQueue
-{
-public:
-    using Task = std::function<void()>;
-    
-    std::queue<Task> q_tasks_;
-
-    void submit(const Task& t)
-    {
-        q_tasks_.push(t);
-    }
-
-    void run()
-    {
-        while(!q_tasks_.empty())
-        {
-            Task task = q_tasks_.front();
-            q_tasks_.pop();
-
-            try
-            {
-                task(); 
-            }
-            catch(const std::exception& e)
-            {
-                std::cerr << e.what() << '\n';
-            }                    
-        }
-    }
-};
-
 struct Printer
 {
     int id;
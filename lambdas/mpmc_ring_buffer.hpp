@@ -0,0 +1,218 @@
+#ifndef MPMC_RING_BUFFER_HPP
+#define MPMC_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// MpmcRingBuffer - bounded lock-free multi-producer/multi-consumer queue
+//
+// Concurrency::MpmcRingBuffer<Task> buffer{1024};
+// buffer.try_push(std::move(task));    // false if full - task is left untouched
+// buffer.push(std::move(task));        // waits for free space (backpressure)
+// buffer.pop_n(tasks, 16);             // up to 16 items claimed by one CAS
+//
+// Every cell has a sequence number (D. Vyukov's bounded queue): a producer claims a cell by CAS on
+// the enqueue position, fills it & publishes it by the cell's sequence - no locks, no allocation
+// after construction. Positions & cells are padded to separate cache lines.
+
+namespace Concurrency
+{
+    constexpr std::size_t cache_line_size = 64;
+
+    template <typename T>
+    class MpmcRingBuffer
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Items must be nothrow movable");
+
+        struct alignas(cache_line_size) Cell
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T& item() noexcept
+            {
+                return *std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+    public:
+        explicit MpmcRingBuffer(std::size_t capacity)
+            : mask_{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1}
+            , cells_{std::make_unique<Cell[]>(mask_ + 1)}
+        {
+            for (std::size_t i = 0; i <= mask_; ++i)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+        MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+        ~MpmcRingBuffer()
+        {
+            while (try_pop())
+            {
+            }
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return mask_ + 1;
+        }
+
+        // approximate when used concurrently
+        std::size_t size() const noexcept
+        {
+            const std::size_t tail = dequeue_pos_.load(std::memory_order_relaxed);
+            const std::size_t head = enqueue_pos_.load(std::memory_order_relaxed);
+            return head > tail ? head - tail : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        // value is moved only if it was pushed
+        bool try_push(T&& value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        bool try_push(const T& value)
+        {
+            if constexpr (std::is_nothrow_copy_constructible_v<T>)
+                return try_emplace(value);
+            else
+                return try_emplace(T(value)); // a throwing copy is made before a cell is claimed
+        }
+
+        // item is constructed in place - args are not consumed if the buffer is full;
+        // the construction must not throw - a claimed cell would never be published & consumers would stall
+        template <typename... TArgs>
+            requires std::is_nothrow_constructible_v<T, TArgs...>
+        bool try_emplace(TArgs&&... args)
+        {
+            std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                Cell& cell = cells_[pos & mask_];
+                const auto diff = static_cast<std::ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - pos);
+
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        ::new (static_cast<void*>(cell.storage)) T(std::forward<TArgs>(args)...);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false; // full
+                else
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // waits while the buffer is full
+        void push(T&& value)
+        {
+            emplace(std::move(value));
+        }
+
+        void push(const T& value)
+        {
+            if constexpr (std::is_nothrow_copy_constructible_v<T>)
+                emplace(value);
+            else
+                emplace(T(value));
+        }
+
+        template <typename... TArgs>
+            requires std::is_nothrow_constructible_v<T, TArgs...>
+        void emplace(TArgs&&... args)
+        {
+            for (Backoff backoff; !try_emplace(std::forward<TArgs>(args)...); backoff())
+            {
+            }
+        }
+
+        std::optional<T> try_pop()
+        {
+            std::optional<T> result;
+            pop_n(&result, 1);
+            return result;
+        }
+
+        // moves up to max_count items to out (iterator to T or std::optional<T>) - returns the number of items
+        template <typename OutputIterator>
+        std::size_t pop_n(OutputIterator out, std::size_t max_count)
+        {
+            std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            std::size_t count;
+
+            while (true)
+            {
+                count = 0;
+                while (count < max_count && cells_[(pos + count) & mask_].sequence.load(std::memory_order_acquire) == pos + count + 1)
+                    ++count;
+
+                if (count == 0)
+                {
+                    const Cell& cell = cells_[pos & mask_];
+                    if (static_cast<std::ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - (pos + 1)) < 0)
+                        return 0; // empty
+
+                    pos = dequeue_pos_.load(std::memory_order_relaxed); // other consumer was faster
+                    continue;
+                }
+
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                    break;
+            }
+
+            for (std::size_t i = 0; i < count; ++i, ++out)
+            {
+                Cell& cell = cells_[(pos + i) & mask_];
+                *out = std::move(cell.item());
+                cell.item().~T();
+                cell.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+            }
+
+            return count;
+        }
+
+    private:
+        class Backoff
+        {
+            int spins_ = 0;
+
+        public:
+            void operator()()
+            {
+                if (++spins_ < 64)
+                    return;
+
+                std::this_thread::yield();
+            }
+        };
+
+        alignas(cache_line_size) std::atomic<std::size_t> enqueue_pos_{0};
+        alignas(cache_line_size) std::atomic<std::size_t> dequeue_pos_{0};
+        alignas(cache_line_size) const std::size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+
+    };
+} // namespace Concurrency
+
+#endif
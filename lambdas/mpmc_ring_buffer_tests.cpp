@@ -0,0 +1,278 @@
+#include "mpmc_ring_buffer.hpp"
+#include "task_queue.hpp"
+
+#include <alloc_tracker.hpp>
+#include <array>
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Concurrency::MpmcRingBuffer;
+
+TEST_CASE("MpmcRingBuffer")
+{
+    SECTION("capacity is rounded up to a power of two")
+    {
+        MpmcRingBuffer<int> buffer{100};
+        CHECK(buffer.capacity() == 128);
+    }
+
+    SECTION("FIFO order & try_push fails when full")
+    {
+        MpmcRingBuffer<int> buffer{4};
+
+        for (int i = 1; i <= 4; ++i)
+            REQUIRE(buffer.try_push(i));
+        CHECK_FALSE(buffer.try_push(5));
+        CHECK(buffer.size() == 4);
+
+        CHECK(buffer.try_pop() == 1);
+        CHECK(buffer.try_push(5));
+
+        std::array<int, 8> items{};
+        CHECK(buffer.pop_n(items.begin(), items.size()) == 4);
+        CHECK(items[0] == 2);
+        CHECK(items[3] == 5);
+
+        CHECK(buffer.try_pop() == std::nullopt);
+        CHECK(buffer.empty());
+    }
+
+    SECTION("move-only items - rejected item is not moved from")
+    {
+        MpmcRingBuffer<std::unique_ptr<int>> buffer{2};
+        buffer.push(std::make_unique<int>(1));
+        buffer.push(std::make_unique<int>(2));
+
+        auto rejected = std::make_unique<int>(3);
+        CHECK_FALSE(buffer.try_push(std::move(rejected)));
+        CHECK(rejected != nullptr);
+
+        CHECK(**buffer.try_pop() == 1);
+    }
+
+    SECTION("throwing copy doesn't claim a cell")
+    {
+        struct ThrowingCopy
+        {
+            int value;
+
+            explicit ThrowingCopy(int v)
+                : value{v}
+            {
+            }
+
+            ThrowingCopy(const ThrowingCopy& other)
+                : value{other.value}
+            {
+                if (value < 0)
+                    throw std::runtime_error("Copy failed");
+            }
+
+            ThrowingCopy(ThrowingCopy&&) noexcept = default;
+            ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+        };
+
+        MpmcRingBuffer<ThrowingCopy> buffer{2};
+        const ThrowingCopy failing{-1};
+        const ThrowingCopy item{1};
+
+        CHECK_THROWS_AS(buffer.try_push(failing), std::runtime_error);
+        CHECK(buffer.try_push(item));
+
+        auto popped = buffer.try_pop();
+        REQUIRE(popped);
+        CHECK(popped->value == 1);
+    }
+
+    SECTION("no allocations after construction")
+    {
+        MpmcRingBuffer<std::string> buffer{16};
+
+        AllocTracker::Scope scope;
+        for (int i = 0; i < 100; ++i)
+        {
+            buffer.push("short");
+            buffer.try_pop();
+        }
+
+        CHECK(scope.allocations() == 0);
+    }
+
+    SECTION("pending items are destroyed with the buffer")
+    {
+        auto item = std::make_shared<int>(1);
+        {
+            MpmcRingBuffer<std::shared_ptr<int>> buffer{4};
+            buffer.push(item);
+            buffer.push(item);
+            CHECK(item.use_count() == 3);
+        }
+        CHECK(item.use_count() == 1);
+    }
+}
+
+namespace
+{
+    // mutex + std::queue - the same push/pop_n interface
+    template <typename T>
+    class LockedQueue
+    {
+    public:
+        void push(T value)
+        {
+            std::lock_guard lk{mtx_};
+            items_.push(std::move(value));
+        }
+
+        template <typename OutputIterator>
+        std::size_t pop_n(OutputIterator out, std::size_t max_count)
+        {
+            std::lock_guard lk{mtx_};
+
+            std::size_t count = 0;
+            for (; count < max_count && !items_.empty(); ++count, ++out)
+            {
+                *out = std::move(items_.front());
+                items_.pop();
+            }
+
+            return count;
+        }
+
+    private:
+        std::mutex mtx_;
+        std::queue<T> items_;
+    };
+
+    // returns the sum of consumed items
+    template <typename Queue>
+    long long transfer(Queue& queue, int producers, int consumers, int items_per_producer)
+    {
+        const long long total = static_cast<long long>(producers) * items_per_producer;
+        std::atomic<long long> consumed{0};
+        std::atomic<long long> sum{0};
+
+        std::vector<std::jthread> threads;
+        for (int p = 0; p < producers; ++p)
+            threads.emplace_back([&] {
+                for (int i = 1; i <= items_per_producer; ++i)
+                    queue.push(i);
+            });
+
+        for (int c = 0; c < consumers; ++c)
+            threads.emplace_back([&] {
+                std::array<int, 16> batch;
+                long long local_sum = 0;
+
+                while (consumed.load(std::memory_order_relaxed) < total)
+                {
+                    const std::size_t count = queue.pop_n(batch.begin(), batch.size());
+                    if (count == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    for (std::size_t i = 0; i < count; ++i)
+                        local_sum += batch[i];
+                    consumed.fetch_add(count, std::memory_order_relaxed);
+                }
+
+                sum += local_sum;
+            });
+
+        threads.clear();
+
+        return sum;
+    }
+} // namespace
+
+TEST_CASE("MpmcRingBuffer - many producers & consumers")
+{
+    MpmcRingBuffer<int> buffer{64}; // small - producers are blocked by backpressure
+
+    const int items_per_producer = 10'000;
+    const long long expected = 4LL * items_per_producer * (items_per_producer + 1) / 2;
+
+    CHECK(transfer(buffer, 4, 4, items_per_producer) == expected);
+    CHECK(buffer.empty());
+}
+
+TEST_CASE("ConcurrentTaskQueue")
+{
+    ConcurrentTaskQueue q{256};
+    std::atomic<int> counter = 0;
+
+    SECTION("tasks posted by many threads")
+    {
+        std::jthread consumer{[&] { // producers post more tasks than the capacity - they wait for the consumer
+            while (counter < 1'000)
+                q.run();
+        }};
+
+        {
+            std::vector<std::jthread> producers;
+            for (int p = 0; p < 4; ++p)
+                producers.emplace_back([&] {
+                    for (int i = 0; i < 250; ++i)
+                        q.post([&counter] { ++counter; });
+                });
+        }
+
+        consumer.join();
+
+        CHECK(counter == 1'000);
+    }
+
+    SECTION("many threads run the queue")
+    {
+        for (int i = 0; i < 200; ++i)
+            q.post([&counter] { ++counter; });
+
+        {
+            std::vector<std::jthread> consumers;
+            for (int c = 0; c < 4; ++c)
+                consumers.emplace_back([&q] { q.run(); });
+        }
+
+        CHECK(counter == 200);
+    }
+
+    SECTION("submit returns a future")
+    {
+        auto f = q.submit([] { return 42; });
+        q.run();
+
+        CHECK(f.get() == 42);
+    }
+}
+
+TEST_CASE("MpmcRingBuffer - benchmark", "[.benchmark]")
+{
+    const int items = 200'000;
+
+    for (int threads : {1, 4, 16, 32})
+    {
+        const std::string suffix = " - " + std::to_string(threads) + " producers & " + std::to_string(threads) + " consumers";
+
+        BENCHMARK("mutex & std::queue" + suffix)
+        {
+            LockedQueue<int> queue;
+            return transfer(queue, threads, threads, items / threads);
+        };
+
+        BENCHMARK("MpmcRingBuffer" + suffix)
+        {
+            MpmcRingBuffer<int> buffer{1024};
+            return transfer(buffer, threads, threads, items / threads);
+        };
+    }
+}
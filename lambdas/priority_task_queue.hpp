@@ -0,0 +1,199 @@
+#ifndef PRIORITY_TASK_QUEUE_HPP
+#define PRIORITY_TASK_QUEUE_HPP
+
+#include "unique_function.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// PriorityTaskQueue - TaskQueue with priority classes & earliest-deadline-first order
+//
+// q.submit(task);                        // normal priority
+// q.submit(task, Priority::high);
+// q.submit(task, now + 5ms);             // explicit deadline
+//
+// Every task gets a deadline: explicit or submit time + latency budget of its class
+// (default: high 1 ms, normal 10 ms, low 100 ms). Tasks run in deadline order (binary heap -
+// O(log n) submit & pop), so high priority tasks overtake older low priority ones, but only
+// until a low priority task gets older than its budget - waiting tasks age and can't starve.
+// A task completed after its deadline is counted as a deadline miss.
+// The heap holds only small keys - tasks stay in reused slots & are moved once in and once out.
+
+namespace Executors
+{
+    enum class Priority
+    {
+        high,
+        normal,
+        low
+    };
+
+    constexpr std::size_t priority_count = 3;
+
+    struct SchedulingStats
+    {
+        std::array<std::size_t, priority_count> executed{};
+        std::array<std::size_t, priority_count> deadline_misses{};
+        std::chrono::nanoseconds max_lateness{0}; // completion time - deadline
+        std::size_t exceptions = 0;                // thrown by executed tasks
+
+        std::size_t total_executed() const
+        {
+            return executed[0] + executed[1] + executed[2];
+        }
+
+        std::size_t total_deadline_misses() const
+        {
+            return deadline_misses[0] + deadline_misses[1] + deadline_misses[2];
+        }
+    };
+
+    class PriorityTaskQueue
+    {
+    public:
+        using Task = UniqueFunction<void()>;
+        using Clock = std::chrono::steady_clock;
+        using LatencyBudgets = std::array<Clock::duration, priority_count>;
+
+        static constexpr LatencyBudgets default_budgets{std::chrono::milliseconds{1}, std::chrono::milliseconds{10}, std::chrono::milliseconds{100}};
+
+        explicit PriorityTaskQueue(const LatencyBudgets& budgets = default_budgets)
+            : budgets_{budgets}
+        {
+        }
+
+        void submit(Task task, Priority priority = Priority::normal)
+        {
+            push(std::move(task), priority, Clock::now() + budgets_[index_of(priority)]);
+        }
+
+        void submit(Task task, Clock::time_point deadline, Priority priority = Priority::normal)
+        {
+            push(std::move(task), priority, deadline);
+        }
+
+        // executes the most urgent task - returns false if the queue is empty
+        bool run_one()
+        {
+            if (heap_.empty())
+                return false;
+
+            std::pop_heap(heap_.begin(), heap_.end(), later_deadline);
+            const Entry entry = heap_.back();
+            heap_.pop_back();
+
+            Task task = std::move(slots_[entry.slot]);
+            free_slots_.push_back(entry.slot);
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                ++stats_.exceptions;
+                std::cerr << e.what() << '\n';
+            }
+            catch (...) // must not escape - run() would stop with tasks still queued
+            {
+                ++stats_.exceptions;
+                std::cerr << "Unknown exception\n";
+            }
+
+            account(entry, Clock::now());
+
+            return true;
+        }
+
+        void run()
+        {
+            while (run_one())
+            {
+            }
+        }
+
+        std::size_t size() const
+        {
+            return heap_.size();
+        }
+
+        bool empty() const
+        {
+            return heap_.empty();
+        }
+
+        const SchedulingStats& stats() const
+        {
+            return stats_;
+        }
+
+    private:
+        struct Entry
+        {
+            Clock::time_point deadline;
+            std::uint64_t sequence; // FIFO among equal deadlines
+            std::uint32_t slot;
+            Priority priority;
+        };
+
+        static bool later_deadline(const Entry& a, const Entry& b)
+        {
+            if (a.deadline != b.deadline)
+                return a.deadline > b.deadline;
+            return a.sequence > b.sequence;
+        }
+
+        static std::size_t index_of(Priority priority)
+        {
+            return static_cast<std::size_t>(priority);
+        }
+
+        LatencyBudgets budgets_;
+        std::vector<Entry> heap_;
+        std::vector<Task> slots_;
+        std::vector<std::uint32_t> free_slots_;
+        std::uint64_t next_sequence_ = 0;
+        SchedulingStats stats_;
+
+        void push(Task task, Priority priority, Clock::time_point deadline)
+        {
+            std::uint32_t slot;
+            if (free_slots_.empty())
+            {
+                slot = static_cast<std::uint32_t>(slots_.size());
+                slots_.push_back(std::move(task));
+            }
+            else
+            {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+                slots_[slot] = std::move(task);
+            }
+
+            heap_.push_back(Entry{deadline, next_sequence_++, slot, priority});
+            std::push_heap(heap_.begin(), heap_.end(), later_deadline);
+        }
+
+        void account(const Entry& entry, Clock::time_point completed)
+        {
+            const std::size_t index = index_of(entry.priority);
+            ++stats_.executed[index];
+
+            if (completed > entry.deadline)
+            {
+                ++stats_.deadline_misses[index];
+                stats_.max_lateness = std::max(stats_.max_lateness, std::chrono::duration_cast<std::chrono::nanoseconds>(completed - entry.deadline));
+            }
+        }
+    };
+} // namespace Executors
+
+#endif
@@ -0,0 +1,180 @@
+#include "priority_task_queue.hpp"
+#include "task_queue.hpp"
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Executors::Priority;
+using Executors::PriorityTaskQueue;
+
+TEST_CASE("PriorityTaskQueue")
+{
+    PriorityTaskQueue q;
+    std::vector<std::string> log;
+
+    SECTION("high priority tasks overtake older tasks")
+    {
+        q.submit([&log] { log.push_back("low"); }, Priority::low);
+        q.submit([&log] { log.push_back("normal"); });
+        q.submit([&log] { log.push_back("high"); }, Priority::high);
+        q.run();
+
+        CHECK(log == std::vector<std::string>{"high", "normal", "low"});
+    }
+
+    SECTION("tasks with equal deadlines are run in FIFO order")
+    {
+        const auto deadline = PriorityTaskQueue::Clock::now() + 1h;
+
+        for (const auto* name : {"one", "two", "three"})
+            q.submit([&log, name] { log.push_back(name); }, deadline);
+        q.run();
+
+        CHECK(log == std::vector<std::string>{"one", "two", "three"});
+    }
+
+    SECTION("explicit deadlines - earliest deadline first")
+    {
+        const auto now = PriorityTaskQueue::Clock::now();
+
+        q.submit([&log] { log.push_back("+3h"); }, now + 3h);
+        q.submit([&log] { log.push_back("+1h"); }, now + 1h);
+        q.submit([&log] { log.push_back("+2h"); }, now + 2h, Priority::high);
+        q.run();
+
+        CHECK(log == std::vector<std::string>{"+1h", "+2h", "+3h"});
+    }
+
+    SECTION("missed deadlines are counted")
+    {
+        q.submit([] {}, PriorityTaskQueue::Clock::now() - 1ms, Priority::high);
+        q.submit([] {}, Priority::low);
+        q.run();
+
+        const auto& stats = q.stats();
+        CHECK(stats.total_executed() == 2);
+        CHECK(stats.deadline_misses[0] == 1);
+        CHECK(stats.total_deadline_misses() == 1);
+        CHECK(stats.max_lateness >= 1ms);
+    }
+
+    SECTION("exceptions are isolated per task")
+    {
+        q.submit([] { throw std::runtime_error("Stack overflow"); }, Priority::high);
+        q.submit([] { throw 13; }, Priority::high);
+        q.submit([&log] { log.push_back("done"); });
+        q.run();
+
+        CHECK(log == std::vector<std::string>{"done"});
+        CHECK(q.stats().total_executed() == 3);
+        CHECK(q.stats().exceptions == 2);
+    }
+}
+
+TEST_CASE("PriorityTaskQueue - waiting tasks age")
+{
+    PriorityTaskQueue q{{10ms, 20ms, 20ms}};
+    std::vector<std::string> log;
+
+    q.submit([&log] { log.push_back("low"); }, Priority::low);
+    std::this_thread::sleep_for(15ms); // low task waits longer than the budget difference
+    q.submit([&log] { log.push_back("high"); }, Priority::high);
+    q.run();
+
+    CHECK(log == std::vector<std::string>{"low", "high"});
+}
+
+namespace
+{
+    void busy_work(std::chrono::nanoseconds duration)
+    {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    // queue is saturated with low priority work - every 10th low task triggers an urgent task
+    template <typename SubmitBackground, typename SubmitUrgent, typename Run>
+    std::vector<std::chrono::nanoseconds> urgent_latencies(SubmitBackground submit_background, SubmitUrgent submit_urgent, Run run)
+    {
+        const int low_count = 2'000;
+        std::vector<std::chrono::nanoseconds> latencies;
+        latencies.reserve(low_count / 10);
+
+        for (int i = 0; i < low_count; ++i)
+        {
+            submit_background([&, i] {
+                busy_work(20us);
+
+                if (i % 10 == 0)
+                {
+                    const auto submitted = std::chrono::steady_clock::now();
+                    submit_urgent([&latencies, submitted] { latencies.push_back(std::chrono::steady_clock::now() - submitted); });
+                }
+            });
+        }
+
+        run();
+
+        std::sort(latencies.begin(), latencies.end());
+        return latencies;
+    }
+
+    void print_percentiles(const std::string& name, const std::vector<std::chrono::nanoseconds>& latencies)
+    {
+        const auto percentile = [&](double p) {
+            return std::chrono::duration<double, std::micro>(latencies[static_cast<std::size_t>(p * (latencies.size() - 1))]).count();
+        };
+
+        std::cout << name << " - urgent task latency: p50 = " << percentile(0.5) << " us, p99 = " << percentile(0.99) << " us\n";
+    }
+} // namespace
+
+TEST_CASE("PriorityTaskQueue - benchmark", "[.benchmark]")
+{
+    {
+        TaskQueue q;
+        auto submit = [&q](auto task) { q.post(std::move(task)); };
+        print_percentiles("TaskQueue (FIFO)", urgent_latencies(submit, submit, [&q] { q.run(); }));
+    }
+
+    {
+        PriorityTaskQueue q;
+        print_percentiles("PriorityTaskQueue",
+            urgent_latencies([&q](auto task) { q.submit(std::move(task), Priority::low); },
+                [&q](auto task) { q.submit(std::move(task), Priority::high); },
+                [&q] { q.run(); }));
+        std::cout << "PriorityTaskQueue - deadline misses: " << q.stats().total_deadline_misses() << "\n";
+    }
+
+    const int count = 100'000;
+
+    BENCHMARK("TaskQueue - submit & run 100k tasks")
+    {
+        TaskQueue q;
+        int sum = 0;
+        for (int i = 0; i < count; ++i)
+            q.post([&sum] { ++sum; });
+        q.run();
+        return sum;
+    };
+
+    BENCHMARK("PriorityTaskQueue - submit & run 100k tasks")
+    {
+        PriorityTaskQueue q;
+        int sum = 0;
+        for (int i = 0; i < count; ++i)
+            q.submit([&sum] { ++sum; }, static_cast<Priority>(i % 3));
+        q.run();
+        return sum;
+    };
+}
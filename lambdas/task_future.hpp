@@ -0,0 +1,495 @@
+#ifndef TASK_FUTURE_HPP
+#define TASK_FUTURE_HPP
+
+#include "unique_function.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// TaskFuture - lightweight shared future with continuations for executors (TaskQueue, WorkStealingPool)
+//
+// auto a = q.submit([] { return 21; });
+// auto b = a.then(q, [](int x) { return 2 * x; });     // submitted to q when a is ready
+// auto all = when_all(std::vector{a, b});               // TaskFuture<std::vector<int>>
+// auto c = submit_after(q, {a, b}, [] { ... });         // dependency edges - c runs after a & b
+//
+// - a DAG is scheduled by continuations - no worker is blocked in get()
+// - get() blocks the caller - call it only outside of the executor's tasks
+// - an exception is stored in the future & propagated to the dependent tasks (which are not run);
+//   an exception of a task whose future was discarded is reported by the executor as before
+
+namespace Executors
+{
+    template <typename E>
+    concept Executor = requires(E& executor, UniqueFunction<void()> task) { executor.post(std::move(task)); };
+
+    namespace Detail
+    {
+        class StateBase : public std::enable_shared_from_this<StateBase>
+        {
+        public:
+            using Callback = UniqueFunction<void()>;
+
+            StateBase() = default;
+            StateBase(const StateBase&) = delete;
+            StateBase& operator=(const StateBase&) = delete;
+
+            bool is_ready() const noexcept
+            {
+                return ready_.load(std::memory_order_acquire);
+            }
+
+            void wait() const noexcept
+            {
+                while (!ready_.load(std::memory_order_acquire))
+                    ready_.wait(false, std::memory_order_acquire);
+            }
+
+            // returns false if the state isn't ready before the deadline
+            template <typename Clock, typename Duration>
+            bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const
+            {
+                if (is_ready())
+                    return true;
+
+                std::unique_lock lk{mtx_};
+                return cv_ready_.wait_until(lk, deadline, [this] { return ready_.load(std::memory_order_relaxed); });
+            }
+
+            // valid only after the state is ready
+            const std::exception_ptr& exception() const noexcept
+            {
+                return exception_;
+            }
+
+            bool has_continuations() const
+            {
+                std::lock_guard lk{mtx_};
+                return !callbacks_.empty();
+            }
+
+            // callback is invoked by the thread completing the state - immediately if the state is ready
+            void on_ready(Callback callback)
+            {
+                {
+                    std::lock_guard lk{mtx_};
+                    if (!ready_.load(std::memory_order_relaxed))
+                    {
+                        callbacks_.push_back(std::move(callback));
+                        return;
+                    }
+                }
+
+                callback();
+            }
+
+            void set_exception(std::exception_ptr e)
+            {
+                exception_ = std::move(e);
+                complete();
+            }
+
+        protected:
+            void complete()
+            {
+                std::vector<Callback> callbacks;
+                {
+                    std::lock_guard lk{mtx_};
+                    ready_.store(true, std::memory_order_release);
+                    callbacks.swap(callbacks_);
+                }
+                ready_.notify_all();
+                cv_ready_.notify_all();
+
+                for (auto& callback : callbacks)
+                    callback();
+            }
+
+        private:
+            std::atomic<bool> ready_{false};
+            mutable std::mutex mtx_;
+            mutable std::condition_variable cv_ready_; // timed waits - ready_ is set under mtx_
+            std::vector<Callback> callbacks_;
+            std::exception_ptr exception_;
+        };
+
+        template <typename T>
+        class SharedState : public StateBase
+        {
+        public:
+            template <typename... TArgs>
+            void set_value(TArgs&&... args)
+            {
+                value_.emplace(std::forward<TArgs>(args)...);
+                complete();
+            }
+
+            const T& value() const noexcept
+            {
+                return *value_;
+            }
+
+        private:
+            std::optional<T> value_;
+        };
+
+        template <>
+        class SharedState<void> : public StateBase
+        {
+        public:
+            void set_value()
+            {
+                complete();
+            }
+        };
+
+        template <typename T, typename F>
+        struct ContinuationResult
+        {
+            using type = std::invoke_result_t<F&, const T&>;
+        };
+
+        template <typename F>
+        struct ContinuationResult<void, F>
+        {
+            using type = std::invoke_result_t<F&>;
+        };
+
+        // exceptions thrown by f are propagated to the caller
+        template <typename R, typename F, typename... TArgs>
+        void fulfil(SharedState<R>& state, F& f, const TArgs&... args)
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                std::invoke(f, args...);
+                state.set_value();
+            }
+            else
+                state.set_value(std::invoke(f, args...));
+        }
+
+        template <typename T, typename R, typename F>
+        void continue_with(const SharedState<T>& antecedent, SharedState<R>& next, F& f)
+        {
+            if (antecedent.exception())
+            {
+                next.set_exception(antecedent.exception());
+                return;
+            }
+
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                    fulfil(next, f);
+                else
+                    fulfil(next, f, antecedent.value());
+            }
+            catch (...)
+            {
+                next.set_exception(std::current_exception());
+            }
+        }
+
+        // done(first exception or nullptr) is called once all states are ready
+        inline void on_all_ready(const std::vector<StateBase*>& states, UniqueFunction<void(std::exception_ptr)> done)
+        {
+            struct Join
+            {
+                std::atomic<std::size_t> remaining;
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+                UniqueFunction<void(std::exception_ptr)> done;
+            };
+
+            if (states.empty())
+            {
+                done(nullptr);
+                return;
+            }
+
+            auto join = std::make_shared<Join>(states.size());
+            join->done = std::move(done);
+
+            for (StateBase* state : states)
+            {
+                state->on_ready([join, state] {
+                    if (state->exception() && !join->failed.exchange(true, std::memory_order_relaxed))
+                        join->error = state->exception();
+
+                    if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        join->done(join->error);
+                });
+            }
+        }
+    } // namespace Detail
+
+    template <typename T>
+    class TaskFuture
+    {
+    public:
+        using value_type = T;
+
+        TaskFuture() = default;
+
+        explicit TaskFuture(std::shared_ptr<Detail::SharedState<T>> state) noexcept
+            : state_{std::move(state)}
+        {
+        }
+
+        bool valid() const noexcept
+        {
+            return state_ != nullptr;
+        }
+
+        bool is_ready() const noexcept
+        {
+            return state_->is_ready();
+        }
+
+        void wait() const noexcept
+        {
+            state_->wait();
+        }
+
+        template <typename Rep, typename Period>
+        std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            return wait_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        template <typename Clock, typename Duration>
+        std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const
+        {
+            return state_->wait_until(deadline) ? std::future_status::ready : std::future_status::timeout;
+        }
+
+        // blocks until the result is ready - rethrows the exception of the task
+        decltype(auto) get() const
+        {
+            state_->wait();
+
+            if (state_->exception())
+                std::rethrow_exception(state_->exception());
+
+            if constexpr (!std::is_void_v<T>)
+                return state_->value();
+        }
+
+        // f(value) is invoked by the thread completing this future
+        template <typename F>
+        auto then(F&& f) -> TaskFuture<typename Detail::ContinuationResult<T, std::decay_t<F>>::type>
+        {
+            using R = typename Detail::ContinuationResult<T, std::decay_t<F>>::type;
+
+            auto next = std::make_shared<Detail::SharedState<R>>();
+            state_->on_ready([antecedent = state_.get(), next, f = std::forward<F>(f)]() mutable {
+                Detail::continue_with(*antecedent, *next, f);
+            });
+
+            return TaskFuture<R>{std::move(next)};
+        }
+
+        // f(value) is posted to the executor when this future is ready
+        template <Executor E, typename F>
+        auto then(E& executor, F&& f) -> TaskFuture<typename Detail::ContinuationResult<T, std::decay_t<F>>::type>
+        {
+            using R = typename Detail::ContinuationResult<T, std::decay_t<F>>::type;
+
+            auto next = std::make_shared<Detail::SharedState<R>>();
+            state_->on_ready([&executor, antecedent = state_.get(), next, f = std::forward<F>(f)]() mutable {
+                executor.post([antecedent = std::static_pointer_cast<Detail::SharedState<T>>(antecedent->shared_from_this()),
+                                  next = std::move(next), f = std::move(f)]() mutable {
+                    Detail::continue_with(*antecedent, *next, f);
+                });
+            });
+
+            return TaskFuture<R>{std::move(next)};
+        }
+
+        const std::shared_ptr<Detail::SharedState<T>>& shared_state() const noexcept
+        {
+            return state_;
+        }
+
+    private:
+        std::shared_ptr<Detail::SharedState<T>> state_;
+    };
+
+    // type-erased future - a dependency of a task
+    class AnyFuture
+    {
+    public:
+        template <typename T>
+        AnyFuture(const TaskFuture<T>& future)
+            : state_{future.shared_state()}
+        {
+        }
+
+        Detail::StateBase* shared_state() const noexcept
+        {
+            return state_.get();
+        }
+
+    private:
+        std::shared_ptr<Detail::StateBase> state_;
+    };
+
+    template <Executor E, typename F>
+    auto submit(E& executor, F&& f) -> TaskFuture<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>&>;
+
+        auto state = std::make_shared<Detail::SharedState<R>>();
+        TaskFuture<R> future{state};
+
+        executor.post([state = std::move(state), f = std::forward<F>(f)]() mutable {
+            try
+            {
+                Detail::fulfil(*state, f);
+            }
+            catch (...)
+            {
+                if (state.use_count() == 1 && !state->has_continuations()) // nobody observes the result
+                    throw;
+                state->set_exception(std::current_exception());
+            }
+        });
+
+        return future;
+    }
+
+    // f is posted to the executor when all dependencies are completed - it's not run if any of them failed
+    template <Executor E, typename F>
+    auto submit_after(E& executor, const std::vector<AnyFuture>& dependencies, F&& f) -> TaskFuture<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>&>;
+
+        auto state = std::make_shared<Detail::SharedState<R>>();
+        TaskFuture<R> future{state};
+
+        std::vector<Detail::StateBase*> states;
+        states.reserve(dependencies.size());
+        for (const auto& dependency : dependencies)
+            states.push_back(dependency.shared_state());
+
+        Detail::on_all_ready(states, [&executor, state = std::move(state), f = std::forward<F>(f)](std::exception_ptr error) mutable {
+            if (error)
+            {
+                state->set_exception(std::move(error));
+                return;
+            }
+
+            executor.post([state = std::move(state), f = std::move(f)]() mutable {
+                try
+                {
+                    Detail::fulfil(*state, f);
+                }
+                catch (...)
+                {
+                    state->set_exception(std::current_exception());
+                }
+            });
+        });
+
+        return future;
+    }
+
+    template <typename T>
+    using WhenAllResult = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+    // ready when all futures are ready - values in the order of futures or the first exception
+    template <typename T>
+    TaskFuture<WhenAllResult<T>> when_all(const std::vector<TaskFuture<T>>& futures)
+    {
+        using R = WhenAllResult<T>;
+
+        auto result = std::make_shared<Detail::SharedState<R>>();
+        TaskFuture<R> future{result};
+
+        std::vector<Detail::StateBase*> states;
+        states.reserve(futures.size());
+
+        if constexpr (std::is_void_v<T>)
+        {
+            for (const auto& f : futures)
+                states.push_back(f.shared_state().get());
+
+            Detail::on_all_ready(states, [result](std::exception_ptr error) {
+                if (error)
+                    result->set_exception(std::move(error));
+                else
+                    result->set_value();
+            });
+        }
+        else
+        {
+            std::vector<std::shared_ptr<Detail::SharedState<T>>> sources;
+            sources.reserve(futures.size());
+            for (const auto& f : futures)
+            {
+                states.push_back(f.shared_state().get());
+                sources.push_back(f.shared_state());
+            }
+
+            Detail::on_all_ready(states, [result, sources = std::move(sources)](std::exception_ptr error) {
+                if (error)
+                {
+                    result->set_exception(std::move(error));
+                    return;
+                }
+
+                std::vector<T> collected; // all sources are ready - values are read after the join
+                collected.reserve(sources.size());
+                for (const auto& source : sources)
+                    collected.push_back(source->value());
+
+                result->set_value(std::move(collected));
+            });
+        }
+
+        return future;
+    }
+
+    // ready when the first future is ready - value is its index
+    template <typename T>
+    TaskFuture<std::size_t> when_any(const std::vector<TaskFuture<T>>& futures)
+    {
+        if (futures.empty())
+            throw std::invalid_argument("when_any needs at least one future");
+
+        struct Race
+        {
+            std::atomic<bool> done{false};
+            std::shared_ptr<Detail::SharedState<std::size_t>> result = std::make_shared<Detail::SharedState<std::size_t>>();
+        };
+
+        auto race = std::make_shared<Race>();
+        TaskFuture<std::size_t> future{race->result};
+
+        for (std::size_t i = 0; i < futures.size(); ++i)
+        {
+            futures[i].shared_state()->on_ready([race, i] {
+                if (!race->done.exchange(true, std::memory_order_acq_rel))
+                    race->result->set_value(i);
+            });
+        }
+
+        return future;
+    }
+} // namespace Executors
+
+#endif
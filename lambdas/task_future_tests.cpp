@@ -0,0 +1,251 @@
+#include "task_future.hpp"
+#include "task_queue.hpp"
+#include "thread_pool.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Executors::TaskFuture;
+
+TEST_CASE("TaskFuture")
+{
+    TaskQueue q;
+
+    SECTION("submit returns a future of the result")
+    {
+        TaskFuture<int> f = q.submit([] { return 42; });
+        CHECK_FALSE(f.is_ready());
+
+        q.run();
+
+        REQUIRE(f.is_ready());
+        CHECK(f.get() == 42);
+    }
+
+    SECTION("exception is stored in the future")
+    {
+        TaskFuture<void> f = q.submit([] { throw std::runtime_error("Stack overflow"); });
+        q.run();
+
+        CHECK_THROWS_AS(f.get(), std::runtime_error);
+    }
+
+    SECTION("then - continuation is submitted to the executor")
+    {
+        std::vector<std::string> log;
+
+        auto f = q.submit([&log] { log.push_back("first"); return 21; })
+                     .then(q, [&log](int x) { log.push_back("then"); return std::to_string(2 * x); });
+        q.submit([&log] { log.push_back("second"); });
+        q.run();
+
+        CHECK(f.get() == "42");
+        CHECK(log == std::vector<std::string>{"first", "second", "then"});
+    }
+
+    SECTION("then - continuation of a ready future is run immediately")
+    {
+        auto f = q.submit([] { return 1; });
+        q.run();
+
+        CHECK(f.then([](int x) { return x + 1; }).get() == 2);
+    }
+
+    SECTION("then - exception skips continuations")
+    {
+        bool called = false;
+
+        auto f = q.submit([]() -> int { throw std::runtime_error("Stack overflow"); })
+                     .then(q, [&called](int x) { called = true; return x; });
+        q.run();
+
+        CHECK_THROWS_AS(f.get(), std::runtime_error);
+        CHECK_FALSE(called);
+    }
+
+    SECTION("when_all - values in the order of futures")
+    {
+        std::vector<TaskFuture<int>> futures;
+        for (int i = 1; i <= 4; ++i)
+            futures.push_back(q.submit([i] { return i * i; }));
+
+        auto all = Executors::when_all(futures);
+        q.run();
+
+        CHECK(all.get() == std::vector{1, 4, 9, 16});
+    }
+
+    SECTION("when_all - first exception is propagated")
+    {
+        std::vector<TaskFuture<void>> futures{q.submit([] {}), q.submit([] { throw std::out_of_range("Index"); })};
+
+        auto all = Executors::when_all(futures);
+        q.run();
+
+        CHECK_THROWS_AS(all.get(), std::out_of_range);
+    }
+
+    SECTION("when_any - index of the first completed future")
+    {
+        TaskQueue other;
+        std::vector<TaskFuture<int>> futures{other.submit([] { return 1; }), q.submit([] { return 2; })};
+
+        auto any = Executors::when_any(futures);
+        q.run();
+
+        CHECK(any.get() == 1);
+    }
+
+    SECTION("submit_after - dependency edges")
+    {
+        std::vector<std::string> log;
+
+        TaskQueue later;
+        auto a = later.submit([&log] { log.push_back("a"); return 1; });
+        auto b = q.submit([&log] { log.push_back("b"); });
+        auto c = Executors::submit_after(q, {a, b}, [&log] { log.push_back("c"); return "c"s; });
+
+        q.run();
+        CHECK(log == std::vector<std::string>{"b"});
+
+        later.run();
+        q.run();
+        CHECK(log == std::vector<std::string>{"b", "a", "c"});
+        CHECK(c.get() == "c");
+    }
+
+    SECTION("submit_after - failed dependency cancels the task")
+    {
+        bool called = false;
+
+        auto a = q.submit([] { throw std::runtime_error("Stack overflow"); });
+        auto b = Executors::submit_after(q, {a}, [&called] { called = true; });
+        q.run();
+
+        CHECK_THROWS_AS(b.get(), std::runtime_error);
+        CHECK_FALSE(called);
+    }
+
+    SECTION("wait_for - timeout & ready")
+    {
+        auto f = q.submit([] { return 42; });
+        CHECK(f.wait_for(1ms) == std::future_status::timeout);
+
+        q.run();
+        CHECK(f.wait_for(0ms) == std::future_status::ready);
+    }
+
+    SECTION("wait_for - polling doesn't register continuations")
+    {
+        auto state = std::make_shared<Executors::Detail::SharedState<int>>();
+        TaskFuture<int> f{state};
+
+        for (int i = 0; i < 100; ++i)
+            CHECK(f.wait_for(0ms) == std::future_status::timeout);
+        CHECK_FALSE(state->has_continuations());
+
+        std::thread completer{[state] {
+            std::this_thread::sleep_for(5ms);
+            state->set_value(42);
+        }};
+        CHECK(f.wait_for(10s) == std::future_status::ready);
+        CHECK(f.get() == 42);
+        completer.join();
+    }
+}
+
+namespace
+{
+    int leaf(int branch, int index)
+    {
+        int result = 0;
+        for (int i = 0; i < 2'000; ++i) // ~ few us of work
+            result += (branch * 31 + index * 17 + i) % 7;
+        return result;
+    }
+
+    constexpr int branches = 64;
+    constexpr int leaves = 16;
+
+    // fan-out: branches x leaves, fan-in: sum of branches - nested futures joined by continuations
+    TaskFuture<int> fan_out_fan_in(Executors::WorkStealingPool& pool)
+    {
+        std::vector<TaskFuture<int>> branch_sums;
+        branch_sums.reserve(branches);
+
+        for (int b = 0; b < branches; ++b)
+        {
+            std::vector<TaskFuture<int>> leaf_results;
+            leaf_results.reserve(leaves);
+            for (int l = 0; l < leaves; ++l)
+                leaf_results.push_back(pool.submit([b, l] { return leaf(b, l); }));
+
+            branch_sums.push_back(Executors::when_all(leaf_results).then(pool, [](const std::vector<int>& values) {
+                return std::accumulate(values.begin(), values.end(), 0);
+            }));
+        }
+
+        return Executors::when_all(branch_sums).then([](const std::vector<int>& values) {
+            return std::accumulate(values.begin(), values.end(), 0);
+        });
+    }
+
+    // the same DAG - every branch blocks its thread in get()
+    int fan_out_fan_in_async()
+    {
+        std::vector<std::future<int>> branch_sums;
+        branch_sums.reserve(branches);
+
+        for (int b = 0; b < branches; ++b)
+        {
+            branch_sums.push_back(std::async(std::launch::async, [b] {
+                std::vector<std::future<int>> leaf_results;
+                for (int l = 0; l < leaves; ++l)
+                    leaf_results.push_back(std::async(std::launch::async, leaf, b, l));
+
+                int sum = 0;
+                for (auto& f : leaf_results)
+                    sum += f.get();
+                return sum;
+            }));
+        }
+
+        int total = 0;
+        for (auto& f : branch_sums)
+            total += f.get();
+        return total;
+    }
+} // namespace
+
+TEST_CASE("TaskFuture - fan-out/fan-in DAG on WorkStealingPool")
+{
+    Executors::WorkStealingPool pool{4};
+
+    CHECK(fan_out_fan_in(pool).get() == fan_out_fan_in_async());
+}
+
+TEST_CASE("TaskFuture - DAG benchmark", "[.benchmark]")
+{
+    BENCHMARK("std::async - 64 x 16 fan-out/fan-in")
+    {
+        return fan_out_fan_in_async();
+    };
+
+    for (std::size_t workers : {1, 4, 16})
+    {
+        BENCHMARK_ADVANCED("WorkStealingPool & TaskFuture - " + std::to_string(workers) + " workers - 64 x 16 fan-out/fan-in")(Catch::Benchmark::Chronometer meter)
+        {
+            Executors::WorkStealingPool pool{workers};
+            meter.measure([&] { return fan_out_fan_in(pool).get(); });
+        };
+    }
+}
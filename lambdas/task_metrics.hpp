@@ -0,0 +1,284 @@
+#ifndef TASK_METRICS_HPP
+#define TASK_METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////
+// Metrics - instrumentation of TaskQueue
+//
+// Metrics::Snapshot s = q.metrics();
+// std::cout << s.to_text();              // or s.to_json()
+//
+// Metrics::PeriodicReporter reporter{1s, [&q] { return q.metrics(); }, [](const auto& s) { log(s.to_json()); }};
+//
+// - HDR-style histograms: 16 linear sub-buckets per power of two (relative error < 6.25%)
+// - every worker (thread calling run()) writes only its own counters - snapshot merges them
+// - wait & execution times are measured for every n-th posted task (clock reads dominate the cost)
+
+namespace Metrics
+{
+    using Nanoseconds = std::uint64_t;
+
+    inline Nanoseconds now() noexcept
+    {
+        return static_cast<Nanoseconds>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    class Histogram
+    {
+    public:
+        static constexpr unsigned sub_bucket_bits = 4;
+        static constexpr unsigned magnitude_bits = 40; // up to ~18 minutes - larger values are clamped
+        static constexpr std::size_t bucket_count = (magnitude_bits - sub_bucket_bits + 1) << sub_bucket_bits;
+
+        static constexpr std::size_t bucket_of(Nanoseconds value) noexcept
+        {
+            constexpr Nanoseconds max_value = (Nanoseconds{1} << magnitude_bits) - 1;
+            value = std::min(value, max_value);
+
+            if (value < (1u << sub_bucket_bits))
+                return static_cast<std::size_t>(value);
+
+            const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bucket_bits;
+            return ((shift + 1) << sub_bucket_bits) + static_cast<std::size_t>((value >> shift) & ((1u << sub_bucket_bits) - 1));
+        }
+
+        // the highest value counted in the bucket
+        static constexpr Nanoseconds upper_bound_of(std::size_t bucket) noexcept
+        {
+            if (bucket < (1u << sub_bucket_bits))
+                return bucket;
+
+            const unsigned shift = static_cast<unsigned>(bucket >> sub_bucket_bits) - 1;
+            const Nanoseconds sub_bucket = bucket & ((1u << sub_bucket_bits) - 1);
+            return (((1u << sub_bucket_bits) + sub_bucket) << shift) + (Nanoseconds{1} << shift) - 1;
+        }
+
+        void record(Nanoseconds value) noexcept
+        {
+            add(bucket_of(value), 1, value, value);
+        }
+
+        void add(std::size_t bucket, std::uint64_t count, Nanoseconds sum, Nanoseconds max) noexcept
+        {
+            counts_[bucket] += count;
+            total_ += count;
+            sum_ += sum;
+            max_ = std::max(max_, max);
+        }
+
+        void merge(const Histogram& other) noexcept
+        {
+            for (std::size_t i = 0; i < bucket_count; ++i)
+                counts_[i] += other.counts_[i];
+            total_ += other.total_;
+            sum_ += other.sum_;
+            max_ = std::max(max_, other.max_);
+        }
+
+        std::uint64_t count() const noexcept
+        {
+            return total_;
+        }
+
+        Nanoseconds max() const noexcept
+        {
+            return max_;
+        }
+
+        double mean() const noexcept
+        {
+            return total_ ? static_cast<double>(sum_) / total_ : 0.0;
+        }
+
+        // p in [0, 1]
+        Nanoseconds percentile(double p) const noexcept
+        {
+            if (total_ == 0)
+                return 0;
+
+            const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(p * total_ + 0.5));
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i)
+            {
+                cumulative += counts_[i];
+                if (cumulative >= rank)
+                    return std::min(upper_bound_of(i), max_);
+            }
+
+            return max_;
+        }
+
+    private:
+        std::array<std::uint64_t, bucket_count> counts_{};
+        std::uint64_t total_ = 0;
+        Nanoseconds sum_ = 0;
+        Nanoseconds max_ = 0;
+    };
+
+    struct Snapshot
+    {
+        Nanoseconds uptime = 0;
+        std::uint64_t executed = 0;
+        std::uint64_t exceptions = 0;
+        std::size_t depth = 0;
+        std::size_t depth_high_water = 0;
+        std::size_t workers = 0;
+        Histogram wait_time;      // posted -> started
+        Histogram execution_time; // started -> completed
+
+        // tasks per second since the start of the queue
+        double throughput() const noexcept
+        {
+            return uptime ? executed * 1e9 / uptime : 0.0;
+        }
+
+        std::string to_text() const
+        {
+            std::ostringstream out;
+            out << "tasks executed: " << executed << " (" << throughput() << " tasks/s), exceptions: " << exceptions << "\n"
+                << "queue depth: " << depth << " (high-water: " << depth_high_water << "), workers: " << workers << "\n";
+            print_text(out, "wait time", wait_time);
+            print_text(out, "execution time", execution_time);
+            return out.str();
+        }
+
+        std::string to_json() const
+        {
+            std::ostringstream out;
+            out << "{\"uptime_ns\":" << uptime << ",\"executed\":" << executed << ",\"throughput_per_s\":" << throughput()
+                << ",\"exceptions\":" << exceptions << ",\"depth\":" << depth << ",\"depth_high_water\":" << depth_high_water
+                << ",\"workers\":" << workers << ",\"wait_ns\":";
+            print_json(out, wait_time);
+            out << ",\"execution_ns\":";
+            print_json(out, execution_time);
+            out << "}";
+            return out.str();
+        }
+
+    private:
+        static void print_text(std::ostringstream& out, const char* name, const Histogram& h)
+        {
+            out << name << " [ns]: samples=" << h.count() << " mean=" << h.mean() << " p50=" << h.percentile(0.5) << " p90=" << h.percentile(0.9)
+                << " p99=" << h.percentile(0.99) << " p99.9=" << h.percentile(0.999) << " max=" << h.max() << "\n";
+        }
+
+        static void print_json(std::ostringstream& out, const Histogram& h)
+        {
+            out << "{\"samples\":" << h.count() << ",\"mean\":" << h.mean() << ",\"p50\":" << h.percentile(0.5) << ",\"p90\":" << h.percentile(0.9)
+                << ",\"p99\":" << h.percentile(0.99) << ",\"p999\":" << h.percentile(0.999) << ",\"max\":" << h.max() << "}";
+        }
+    };
+
+    // counters of one worker - written only by the worker's thread, read by snapshots
+    class alignas(64) WorkerMetrics
+    {
+    public:
+        explicit WorkerMetrics(std::thread::id owner)
+            : owner_{owner}
+        {
+        }
+
+        std::thread::id owner() const noexcept
+        {
+            return owner_;
+        }
+
+        void task_executed() noexcept
+        {
+            increment(executed_);
+        }
+
+        void exception_thrown() noexcept
+        {
+            increment(exceptions_);
+        }
+
+        void sampled(Nanoseconds wait_time, Nanoseconds execution_time) noexcept
+        {
+            wait_time_.record(wait_time);
+            execution_time_.record(execution_time);
+        }
+
+        void add_to(Snapshot& snapshot) const noexcept
+        {
+            snapshot.executed += executed_.load(std::memory_order_relaxed);
+            snapshot.exceptions += exceptions_.load(std::memory_order_relaxed);
+            wait_time_.add_to(snapshot.wait_time);
+            execution_time_.add_to(snapshot.execution_time);
+        }
+
+    private:
+        using Counter = std::atomic<std::uint64_t>;
+
+        // single writer - no read-modify-write instruction needed
+        static void increment(Counter& counter, std::uint64_t value = 1) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        struct AtomicHistogram
+        {
+            std::array<Counter, Histogram::bucket_count> counts{};
+            Counter sum{0};
+            Counter max{0};
+
+            void record(Nanoseconds value) noexcept
+            {
+                increment(counts[Histogram::bucket_of(value)]);
+                increment(sum, value);
+                if (value > max.load(std::memory_order_relaxed))
+                    max.store(value, std::memory_order_relaxed);
+            }
+
+            void add_to(Histogram& histogram) const noexcept
+            {
+                for (std::size_t i = 0; i < Histogram::bucket_count; ++i)
+                    if (const std::uint64_t count = counts[i].load(std::memory_order_relaxed))
+                        histogram.add(i, count, 0, 0);
+                histogram.add(0, 0, sum.load(std::memory_order_relaxed), max.load(std::memory_order_relaxed));
+            }
+        };
+
+        std::thread::id owner_;
+        Counter executed_{0};
+        Counter exceptions_{0};
+        AtomicHistogram wait_time_;
+        AtomicHistogram execution_time_;
+    };
+
+    // calls sink(source()) every period on its own thread
+    class PeriodicReporter
+    {
+    public:
+        template <typename Source, typename Sink>
+        PeriodicReporter(std::chrono::milliseconds period, Source source, Sink sink)
+            : thread_{[period, source = std::move(source), sink = std::move(sink)](std::stop_token stop) mutable {
+                std::mutex mtx;
+                std::condition_variable_any cv;
+                std::unique_lock lk{mtx};
+
+                while (!cv.wait_for(lk, stop, period, [] { return false; }) && !stop.stop_requested())
+                    sink(source());
+            }}
+        {
+        }
+
+    private:
+        std::jthread thread_;
+    };
+} // namespace Metrics
+
+#endif
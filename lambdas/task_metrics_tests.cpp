@@ -0,0 +1,232 @@
+#include "task_metrics.hpp"
+#include "task_queue.hpp"
+
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Metrics::Histogram;
+
+TEST_CASE("Metrics::Histogram")
+{
+    SECTION("small values are counted exactly")
+    {
+        for (Metrics::Nanoseconds value = 0; value < 32; ++value)
+        {
+            CHECK(Histogram::bucket_of(value) == value);
+            CHECK(Histogram::upper_bound_of(Histogram::bucket_of(value)) == value);
+        }
+    }
+
+    SECTION("relative error of a bucket is below 1/16")
+    {
+        for (Metrics::Nanoseconds value : {100ull, 1'000ull, 12'345ull, 1'000'000ull, 987'654'321ull})
+        {
+            const Metrics::Nanoseconds upper = Histogram::upper_bound_of(Histogram::bucket_of(value));
+            CHECK(upper >= value);
+            CHECK(upper - value <= value / 16);
+        }
+    }
+
+    SECTION("percentiles")
+    {
+        Histogram h;
+        for (Metrics::Nanoseconds value = 1; value <= 1'000; ++value)
+            h.record(value * 1'000);
+
+        CHECK(h.count() == 1'000);
+        CHECK(h.max() == 1'000'000);
+        CHECK(h.mean() == 500'500.0);
+
+        const auto p50 = h.percentile(0.5);
+        CHECK(p50 >= 500'000);
+        CHECK(p50 <= 500'000 * 17 / 16);
+        CHECK(h.percentile(1.0) == 1'000'000);
+    }
+
+    SECTION("merge")
+    {
+        Histogram a, b;
+        a.record(10);
+        b.record(1'000);
+        b.record(2'000);
+
+        a.merge(b);
+
+        CHECK(a.count() == 3);
+        CHECK(a.max() == 2'000);
+        CHECK(a.percentile(0.1) == 10);
+    }
+}
+
+TEST_CASE("TaskQueue - metrics")
+{
+    TaskQueue q;
+    q.sample_every(1);
+
+    SECTION("executed tasks, exceptions & queue depth")
+    {
+        for (int i = 0; i < 10; ++i)
+            q.post([] {});
+        q.post([] { throw std::runtime_error("Stack overflow"); });
+
+        CHECK(q.metrics().depth == 11);
+        q.run();
+
+        const auto metrics = q.metrics();
+        CHECK(metrics.executed == 11);
+        CHECK(metrics.exceptions == 1);
+        CHECK(metrics.depth == 0);
+        CHECK(metrics.depth_high_water == 11);
+        CHECK(metrics.workers == 1);
+        CHECK(metrics.wait_time.count() == 11);
+    }
+
+    SECTION("non-std exception doesn't lose the rest of the batch")
+    {
+        int executed = 0;
+        q.post([] { throw 13; });
+        for (int i = 0; i < 5; ++i)
+            q.post([&executed] { ++executed; });
+        q.run();
+
+        CHECK(executed == 5);
+        CHECK(q.metrics().exceptions == 1);
+    }
+
+    SECTION("wait & execution times")
+    {
+        q.post([] { std::this_thread::sleep_for(2ms); });
+        q.post([] {});
+        q.run();
+
+        const auto metrics = q.metrics();
+        CHECK(metrics.execution_time.max() >= 2'000'000);
+        CHECK(metrics.wait_time.max() >= 2'000'000); // second task waited for the first
+    }
+
+    SECTION("sampling")
+    {
+        q.sample_every(4);
+        for (int i = 0; i < 64; ++i)
+            q.post([] {});
+        q.run();
+
+        CHECK(q.metrics().executed == 64);
+        CHECK(q.metrics().execution_time.count() == 16);
+
+        CHECK_THROWS_AS(q.sample_every(3), std::invalid_argument);
+    }
+
+    SECTION("export")
+    {
+        q.post([] {});
+        q.run();
+
+        const auto metrics = q.metrics();
+        CHECK(metrics.to_text().find("tasks executed: 1") != std::string::npos);
+        CHECK(metrics.to_json().find("\"executed\":1,") != std::string::npos);
+        CHECK(metrics.to_json().find("\"wait_ns\":{\"samples\":1,") != std::string::npos);
+    }
+}
+
+TEST_CASE("ConcurrentTaskQueue - metrics are merged from workers")
+{
+    ConcurrentTaskQueue q{1024};
+
+    for (int i = 0; i < 1'000; ++i)
+        q.post([] {});
+
+    {
+        std::vector<std::jthread> workers;
+        for (int i = 0; i < 4; ++i)
+            workers.emplace_back([&q] { q.run(); });
+    }
+
+    const auto metrics = q.metrics();
+    CHECK(metrics.workers == 4);
+    CHECK(metrics.executed == 1'000);
+    CHECK(metrics.depth_high_water == 1'000);
+}
+
+TEST_CASE("Metrics::PeriodicReporter")
+{
+    TaskQueue q;
+    std::atomic<int> reports = 0;
+
+    {
+        Metrics::PeriodicReporter reporter{5ms, [&q] { return q.metrics(); }, [&reports](const Metrics::Snapshot&) { ++reports; }};
+        std::this_thread::sleep_for(50ms);
+    }
+
+    CHECK(reports >= 2);
+}
+
+namespace
+{
+    // TaskQueue without instrumentation
+    class PlainQueue
+    {
+    public:
+        void post(Executors::UniqueFunction<void()> task)
+        {
+            tasks_.push(std::move(task));
+        }
+
+        void run()
+        {
+            while (!tasks_.empty())
+            {
+                auto task = std::move(tasks_.front());
+                tasks_.pop();
+                task();
+            }
+        }
+
+    private:
+        std::queue<Executors::UniqueFunction<void()>> tasks_;
+    };
+
+    template <typename Queue>
+    int post_and_run(Queue& q, int count)
+    {
+        int sum = 0;
+        for (int i = 0; i < count; ++i)
+            q.post([&sum] { ++sum; });
+        q.run();
+        return sum;
+    }
+} // namespace
+
+TEST_CASE("TaskQueue - metrics benchmark", "[.benchmark]")
+{
+    const int count = 100'000;
+
+    BENCHMARK("no instrumentation - 100k tasks")
+    {
+        PlainQueue q;
+        return post_and_run(q, count);
+    };
+
+    for (std::uint32_t period : {0u, 64u, 1u})
+    {
+        BENCHMARK("TaskQueue - timing sampled every " + std::to_string(period) + " task(s) - 100k tasks")
+        {
+            TaskQueue q;
+            q.sample_every(period);
+            return post_and_run(q, count);
+        };
+    }
+
+    TaskQueue q;
+    post_and_run(q, count);
+    std::cout << q.metrics().to_text();
+}
@@ -0,0 +1,344 @@
+#ifndef TASK_QUEUE_HPP
+#define TASK_QUEUE_HPP
+
+#include "mpmc_ring_buffer.hpp"
+#include "task_future.hpp"
+#include "task_metrics.hpp"
+#include "timer_wheel.hpp"
+#include "unique_function.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace TaskQueueBackends
+{
+    using Task = Executors::UniqueFunction<void()>; // move-only - captures up to 48 bytes are stored inline
+
+    struct Entry
+    {
+        Task task;
+        Metrics::Nanoseconds posted_at; // 0 - not sampled
+    };
+
+    // unbounded, single-threaded
+    class Sequential
+    {
+    public:
+        void emplace(Task&& task, Metrics::Nanoseconds posted_at)
+        {
+            entries_.emplace(std::move(task), posted_at);
+        }
+
+        bool try_emplace(Task& task, Metrics::Nanoseconds posted_at)
+        {
+            emplace(std::move(task), posted_at);
+            return true;
+        }
+
+        std::size_t pop_n(Entry* out, std::size_t max_count)
+        {
+            std::size_t count = 0;
+            for (; count < max_count && !entries_.empty(); ++count)
+            {
+                out[count] = std::move(entries_.front());
+                entries_.pop();
+            }
+            return count;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return entries_.size();
+        }
+
+    private:
+        std::queue<Entry> entries_;
+    };
+
+    // bounded, lock-free - many threads may post & run concurrently, post() blocks while the queue is full
+    class LockFree
+    {
+    public:
+        explicit LockFree(std::size_t capacity = 1024)
+            : entries_{capacity}
+        {
+        }
+
+        void emplace(Task&& task, Metrics::Nanoseconds posted_at)
+        {
+            entries_.emplace(std::move(task), posted_at);
+        }
+
+        // task is moved only if there was free space
+        bool try_emplace(Task& task, Metrics::Nanoseconds posted_at)
+        {
+            return entries_.try_emplace(std::move(task), posted_at);
+        }
+
+        std::size_t pop_n(Entry* out, std::size_t max_count)
+        {
+            return entries_.pop_n(out, max_count);
+        }
+
+        std::size_t size() const noexcept
+        {
+            return entries_.size();
+        }
+
+    private:
+        Concurrency::MpmcRingBuffer<Entry> entries_;
+    };
+} // namespace TaskQueueBackends
+
+// TaskQueue is instrumented - q.metrics() returns a snapshot of:
+// - histograms of wait & execution times (measured for every 64th posted task - see sample_every())
+// - queue depth & its high-water mark, executed tasks & exceptions merged from all workers
+//
+// Delayed & periodic tasks (post_after, post_at, post_every) are kept in a timing wheel
+// driven by a timer thread (started on first use) - expired tasks are run by run()
+template <typename Backend = TaskQueueBackends::Sequential>
+class BasicTaskQueue
+{
+public:
+    using Task = TaskQueueBackends::Task;
+    using Clock = Timers::TimerService::Clock;
+
+    template <typename... TArgs>
+        requires std::constructible_from<Backend, TArgs...>
+    explicit BasicTaskQueue(TArgs&&... args)
+        : backend_(std::forward<TArgs>(args)...)
+    {
+    }
+
+    // returns TaskFuture of the result
+    template <typename F>
+    auto submit(F&& f)
+    {
+        return Executors::submit(*this, std::forward<F>(f));
+    }
+
+    // fire & forget
+    void post(Task t)
+    {
+        backend_.emplace(std::move(t), sampled_post_time());
+        update_depth_high_water();
+    }
+
+    // posts the task when the delay elapses (1 ms resolution)
+    Timers::TimerId post_after(Clock::duration delay, Task t)
+    {
+        return timers().schedule_after(delay, std::move(t));
+    }
+
+    Timers::TimerId post_at(Clock::time_point deadline, Task t)
+    {
+        return timers().schedule_at(deadline, std::move(t));
+    }
+
+    // posts the task every period until the timer is cancelled
+    Timers::TimerId post_every(Clock::duration period, Task t)
+    {
+        return timers().schedule_every(period, std::move(t));
+    }
+
+    // returns false if the timer has already fired (or was cancelled)
+    bool cancel(Timers::TimerId id)
+    {
+        return timers().cancel(id);
+    }
+
+    // runs tasks until the queue is empty
+    void run()
+    {
+        Metrics::WorkerMetrics& worker = worker_metrics();
+        std::array<TaskQueueBackends::Entry, 16> batch;
+
+        while (true)
+        {
+            post_expired_timers();
+
+            const std::size_t count = backend_.pop_n(batch.data(), batch.size());
+            if (count == 0)
+                return;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto& [task, posted_at] = batch[i];
+                const Metrics::Nanoseconds started_at = posted_at ? Metrics::now() : 0;
+
+                try
+                {
+                    task();
+                }
+                catch (const std::exception& e)
+                {
+                    worker.exception_thrown();
+                    std::cerr << e.what() << '\n';
+                }
+                catch (...) // must not escape - the rest of the batch would be lost
+                {
+                    worker.exception_thrown();
+                    std::cerr << "Unknown exception\n";
+                }
+
+                if (posted_at)
+                    worker.sampled(started_at - posted_at, Metrics::now() - started_at);
+                worker.task_executed();
+
+                task.reset();
+            }
+        }
+    }
+
+    // runs tasks & waits for expired timers until the deadline
+    void run_until(Clock::time_point deadline)
+    {
+        while (true)
+        {
+            run();
+
+            std::unique_lock lk{mtx_expired_};
+            if (!cv_expired_.wait_until(lk, deadline, [this] { return !expired_.empty(); }))
+                return;
+        }
+    }
+
+    void run_for(Clock::duration duration)
+    {
+        run_until(Clock::now() + duration);
+    }
+
+    // wait & execution times are measured for every period-th posted task (power of two, 0 - never)
+    void sample_every(std::uint32_t period)
+    {
+        if (period != 0 && !std::has_single_bit(period))
+            throw std::invalid_argument("Sampling period must be a power of two");
+
+        sample_mask_ = period ? period - 1 : no_sampling;
+    }
+
+    // must not be called concurrently with post() or run() for single-threaded backends
+    Metrics::Snapshot metrics() const
+    {
+        Metrics::Snapshot snapshot;
+        snapshot.uptime = Metrics::now() - created_at_;
+        snapshot.depth = backend_.size();
+        snapshot.depth_high_water = depth_high_water_.load(std::memory_order_relaxed);
+
+        std::lock_guard lk{mtx_workers_};
+        snapshot.workers = workers_.size();
+        for (const auto& worker : workers_)
+            worker->add_to(snapshot);
+
+        return snapshot;
+    }
+
+private:
+    static constexpr std::uint32_t no_sampling = ~std::uint32_t{0};
+    inline static thread_local std::uint32_t post_counter = 0;
+
+    Backend backend_;
+    std::uint32_t sample_mask_ = 63;
+    std::atomic<std::size_t> depth_high_water_{0};
+    Metrics::Nanoseconds created_at_ = Metrics::now();
+
+    mutable std::mutex mtx_workers_;
+    std::vector<std::unique_ptr<Metrics::WorkerMetrics>> workers_;
+
+    std::mutex mtx_expired_;
+    std::condition_variable cv_expired_;
+    std::vector<Task> expired_; // handed over by the timer thread
+    std::atomic<bool> has_expired_{false};
+
+    std::once_flag timers_started_;
+    std::unique_ptr<Timers::TimerService> timers_; // destroyed first - the timer thread stops before the queue
+
+    Timers::TimerService& timers()
+    {
+        std::call_once(timers_started_, [this] {
+            timers_ = std::make_unique<Timers::TimerService>([this](Task t) {
+                {
+                    std::lock_guard lk{mtx_expired_};
+                    expired_.push_back(std::move(t));
+                    has_expired_.store(true, std::memory_order_release);
+                }
+                cv_expired_.notify_all();
+            });
+        });
+
+        return *timers_;
+    }
+
+    Metrics::Nanoseconds sampled_post_time()
+    {
+        if (sample_mask_ != no_sampling && (++post_counter & sample_mask_) == 0)
+            return Metrics::now();
+        return 0;
+    }
+
+    void update_depth_high_water()
+    {
+        const std::size_t depth = backend_.size();
+        if (depth > depth_high_water_.load(std::memory_order_relaxed)) // concurrent posts may underestimate the mark slightly
+            depth_high_water_.store(depth, std::memory_order_relaxed);
+    }
+
+    // called by run() - mustn't block on a full bounded backend (run() may be its only consumer),
+    // so tasks which don't fit are handed back & posted after the next batch
+    void post_expired_timers()
+    {
+        if (!has_expired_.load(std::memory_order_acquire))
+            return;
+
+        std::vector<Task> expired;
+        {
+            std::lock_guard lk{mtx_expired_};
+            expired.swap(expired_);
+            has_expired_.store(false, std::memory_order_relaxed);
+        }
+
+        auto unposted = expired.begin();
+        for (; unposted != expired.end() && backend_.try_emplace(*unposted, sampled_post_time()); ++unposted)
+            update_depth_high_water();
+
+        if (unposted == expired.end())
+            return;
+
+        std::lock_guard lk{mtx_expired_};
+        expired_.insert(expired_.begin(), std::make_move_iterator(unposted), std::make_move_iterator(expired.end()));
+        has_expired_.store(true, std::memory_order_relaxed);
+    }
+
+    Metrics::WorkerMetrics& worker_metrics()
+    {
+        const auto id = std::this_thread::get_id();
+
+        std::lock_guard lk{mtx_workers_};
+        for (const auto& worker : workers_)
+            if (worker->owner() == id)
+                return *worker;
+
+        return *workers_.emplace_back(std::make_unique<Metrics::WorkerMetrics>(id));
+    }
+};
+
+using TaskQueue = BasicTaskQueue<>;
+using ConcurrentTaskQueue = BasicTaskQueue<TaskQueueBackends::LockFree>;
+
+#endif
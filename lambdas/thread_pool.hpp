@@ -0,0 +1,236 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "task_future.hpp"
+#include "unique_function.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// WorkStealingPool - multi-threaded executor with the TaskQueue interface
+//
+// - every worker has its own deque: it pops its newest task (LIFO - hot in cache),
+//   idle workers steal the oldest tasks (FIFO) from other workers
+// - tasks submitted by a worker go to its own deque, external submits are spread round-robin
+// - submit() returns TaskFuture of the result, post() is fire & forget
+// - run() blocks until all submitted tasks (including tasks submitted by tasks) are done
+// - an exception escaping a task is reported & doesn't affect other tasks
+
+namespace Executors
+{
+    class WorkStealingPool
+    {
+    public:
+        using Task = UniqueFunction<void()>;
+
+        explicit WorkStealingPool(std::size_t worker_count = std::max(1u, std::thread::hardware_concurrency()))
+            : queues_(worker_count)
+        {
+            if (worker_count == 0)
+                throw std::invalid_argument("Pool needs at least one worker");
+
+            for (std::size_t i = 0; i < worker_count; ++i)
+                queues_[i] = std::make_unique<WorkerQueue>();
+
+            workers_.reserve(worker_count);
+            for (std::size_t i = 0; i < worker_count; ++i)
+                workers_.emplace_back([this, i] { worker_loop(i); });
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // pending tasks are completed before workers are stopped
+        ~WorkStealingPool()
+        {
+            run();
+
+            {
+                std::lock_guard lk{mtx_idle_};
+                stop_ = true;
+            }
+            cv_work_.notify_all();
+
+            for (auto& worker : workers_)
+                worker.join();
+        }
+
+        template <typename F>
+        auto submit(F&& f)
+        {
+            return Executors::submit(*this, std::forward<F>(f));
+        }
+
+        void post(Task task)
+        {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            queued_.fetch_add(1, std::memory_order_seq_cst);
+
+            const std::size_t index = (current_pool == this) ? current_index : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                std::lock_guard lk{queues_[index]->mtx};
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+
+            if (sleeping_.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard lk{mtx_idle_}; // worker is either before the check of queued_ or already waiting
+                cv_work_.notify_one();
+            }
+        }
+
+        // waits for completion of all submitted tasks - must not be called from a task
+        void run()
+        {
+            std::unique_lock lk{mtx_done_};
+            cv_done_.wait(lk, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+        }
+
+        std::size_t worker_count() const noexcept
+        {
+            return workers_.size();
+        }
+
+        std::size_t exception_count() const noexcept
+        {
+            return exceptions_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct alignas(64) WorkerQueue
+        {
+            std::mutex mtx;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> next_queue_{0};
+
+        std::atomic<std::size_t> queued_{0};  // tasks waiting in deques (counted before a push)
+        std::atomic<std::size_t> pending_{0}; // tasks submitted & not completed
+        std::atomic<std::size_t> exceptions_{0};
+
+        std::mutex mtx_idle_;
+        std::condition_variable cv_work_;
+        std::atomic<std::size_t> sleeping_{0};
+        bool stop_ = false;
+
+        std::mutex mtx_done_;
+        std::condition_variable cv_done_;
+
+        inline static thread_local WorkStealingPool* current_pool = nullptr;
+        inline static thread_local std::size_t current_index = 0;
+
+        std::optional<Task> pop_local(std::size_t index)
+        {
+            WorkerQueue& queue = *queues_[index];
+            std::lock_guard lk{queue.mtx};
+            if (queue.tasks.empty())
+                return std::nullopt;
+
+            Task task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return task;
+        }
+
+        std::optional<Task> steal(std::size_t thief_index)
+        {
+            for (std::size_t offset = 1; offset < queues_.size(); ++offset)
+            {
+                WorkerQueue& victim = *queues_[(thief_index + offset) % queues_.size()];
+                std::unique_lock lk{victim.mtx, std::try_to_lock};
+                if (!lk || victim.tasks.empty())
+                    continue;
+
+                Task task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+
+            return std::nullopt;
+        }
+
+        std::optional<Task> find_task(std::size_t index)
+        {
+            if (queued_.load(std::memory_order_relaxed) == 0)
+                return std::nullopt;
+
+            std::optional<Task> task = pop_local(index);
+            if (!task)
+                task = steal(index);
+
+            if (task)
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+
+            return task;
+        }
+
+        void worker_loop(std::size_t index)
+        {
+            current_pool = this;
+            current_index = index;
+
+            while (true)
+            {
+                if (std::optional<Task> task = find_task(index))
+                {
+                    execute(*task);
+                    continue;
+                }
+
+                if (queued_.load(std::memory_order_relaxed) > 0) // task is being pushed or its deque is locked
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock lk{mtx_idle_};
+                sleeping_.fetch_add(1, std::memory_order_seq_cst);
+                cv_work_.wait(lk, [this] { return stop_ || queued_.load(std::memory_order_seq_cst) > 0; });
+                sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+                if (stop_ && queued_.load() == 0)
+                    return;
+            }
+        }
+
+        void execute(Task& task)
+        {
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                exceptions_.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << e.what() << '\n';
+            }
+            catch (...)
+            {
+                exceptions_.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "Unknown exception\n";
+            }
+
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard lk{mtx_done_};
+                cv_done_.notify_all();
+            }
+        }
+    };
+} // namespace Executors
+
+#endif
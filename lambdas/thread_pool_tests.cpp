@@ -0,0 +1,107 @@
+#include "task_queue.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+
+TEST_CASE("WorkStealingPool")
+{
+    Executors::WorkStealingPool pool{4};
+
+    SECTION("runs all submitted tasks")
+    {
+        std::atomic<int> counter = 0;
+
+        for (int i = 0; i < 1'000; ++i)
+            pool.submit([&counter] { ++counter; });
+
+        pool.run();
+
+        CHECK(counter == 1'000);
+    }
+
+    SECTION("tasks submitted by tasks are completed by run()")
+    {
+        std::atomic<int> counter = 0;
+
+        for (int i = 0; i < 10; ++i)
+            pool.submit([&] {
+                for (int j = 0; j < 100; ++j)
+                    pool.submit([&counter] { ++counter; });
+            });
+
+        pool.run();
+
+        CHECK(counter == 1'000);
+    }
+
+    SECTION("exceptions are isolated per task")
+    {
+        std::atomic<int> counter = 0;
+
+        pool.submit([] { throw std::runtime_error("Stack overflow"); });
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&counter] { ++counter; });
+
+        pool.run();
+
+        CHECK(counter == 100);
+        CHECK(pool.exception_count() == 1);
+    }
+}
+
+namespace
+{
+    void busy_work(std::chrono::nanoseconds duration)
+    {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    template <typename Queue>
+    void submit_tasks(Queue& queue, int count, std::chrono::nanoseconds duration)
+    {
+        for (int i = 0; i < count; ++i)
+            queue.post([duration] { busy_work(duration); });
+
+        queue.run();
+    }
+} // namespace
+
+TEST_CASE("WorkStealingPool - benchmark", "[.benchmark]")
+{
+    struct Workload
+    {
+        std::string name;
+        int count;
+        std::chrono::nanoseconds duration;
+    };
+
+    for (const auto& [name, count, duration] : {Workload{"tiny tasks (100 ns)", 100'000, 100ns}, Workload{"coarse tasks (1 ms)", 64, 1ms}})
+    {
+        BENCHMARK("TaskQueue (serial) - " + name)
+        {
+            TaskQueue q;
+            submit_tasks(q, count, duration);
+        };
+
+        for (std::size_t workers : {1, 4, 16, 64})
+        {
+            BENCHMARK_ADVANCED("WorkStealingPool - " + std::to_string(workers) + " workers - " + name)(Catch::Benchmark::Chronometer meter)
+            {
+                Executors::WorkStealingPool pool{workers};
+                meter.measure([&] { submit_tasks(pool, count, duration); });
+            };
+        }
+    }
+}
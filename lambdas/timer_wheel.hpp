@@ -0,0 +1,434 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include "unique_function.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Timers - hierarchical timing wheel & a timer thread for delayed & periodic tasks
+//
+// TimingWheel wheel;
+// TimerId id = wheel.insert(wheel.now() + 100, task);   // expires after 100 ticks - O(1)
+// wheel.cancel(id);                                      // O(1)
+// wheel.advance_to(tick, [](Task&& expired) { ... });
+//
+// - 4 levels x 256 slots: level 0 holds timers expiring within 256 ticks, level 1 within 256^2 ticks, ...;
+//   when level 0 wraps, the next slot of level 1 is cascaded down (timers move at most 3 times)
+// - timers are nodes of intrusive lists in a slab - a cancelled timer is unlinked & its node reused
+// - a periodic task never runs concurrently with itself - its expiries are skipped while
+//   the previous firing is pending or running
+// - TimerService drives a wheel by one thread (1 ms ticks by default) & dispatches expired tasks
+
+namespace Timers
+{
+    using Task = Executors::UniqueFunction<void()>;
+    using Tick = std::uint64_t;
+
+    struct TimerId
+    {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+    };
+
+    namespace Detail
+    {
+        struct PeriodicTask
+        {
+            Task task;
+            std::atomic<bool> in_flight{false}; // a firing is dispatched & hasn't finished yet
+        };
+
+        // dispatched firing of a periodic timer - in_flight is cleared when it is run or dropped
+        class PeriodicFiring
+        {
+        public:
+            explicit PeriodicFiring(std::shared_ptr<PeriodicTask> timer) noexcept
+                : timer_{std::move(timer)}
+            {
+            }
+
+            PeriodicFiring(PeriodicFiring&&) noexcept = default;
+            PeriodicFiring& operator=(PeriodicFiring&&) = delete;
+
+            ~PeriodicFiring()
+            {
+                if (timer_)
+                    timer_->in_flight.store(false, std::memory_order_release);
+            }
+
+            void operator()()
+            {
+                const PeriodicFiring finished = std::move(*this); // clears in_flight also if the task throws
+                finished.timer_->task();
+            }
+
+        private:
+            std::shared_ptr<PeriodicTask> timer_;
+        };
+    } // namespace Detail
+
+    class TimingWheel
+    {
+        static constexpr unsigned slot_bits = 8;
+        static constexpr std::size_t slot_count = 1 << slot_bits;
+        static constexpr std::size_t slot_mask = slot_count - 1;
+        static constexpr std::size_t level_count = 4;
+        static constexpr Tick max_delta = (Tick{1} << (slot_bits * level_count)) - 1;
+        static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+        struct Node
+        {
+            Task task; // one-shot timer
+            std::shared_ptr<Detail::PeriodicTask> periodic; // periodic timer - fired on every expiry it isn't in flight
+            Tick expiry = 0;
+            Tick period = 0;
+            std::uint32_t prev = nil;
+            std::uint32_t next = nil;
+            std::uint32_t generation = 0;
+            std::uint32_t slot = nil; // level * slot_count + slot index, nil - free node
+        };
+
+    public:
+        Tick now() const noexcept
+        {
+            return now_;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        // timer expiring at or before now() fires on the next tick; period > 0 - periodic timer
+        TimerId insert(Tick expiry, Task task, Tick period = 0)
+        {
+            const std::uint32_t index = allocate_node();
+            Node& node = nodes_[index];
+
+            if (period > 0)
+                node.periodic = std::make_shared<Detail::PeriodicTask>(std::move(task));
+            else
+                node.task = std::move(task);
+            node.expiry = expiry;
+            node.period = period;
+
+            link(index, now_ + 1);
+            ++size_;
+
+            return TimerId{index, node.generation};
+        }
+
+        // returns false if the timer has already fired (one-shot) or was cancelled
+        bool cancel(TimerId id)
+        {
+            if (id.index >= nodes_.size())
+                return false;
+
+            Node& node = nodes_[id.index];
+            if (node.generation != id.generation || node.slot == nil)
+                return false;
+
+            unlink(id.index);
+            release_node(id.index);
+            --size_;
+
+            return true;
+        }
+
+        // advances the wheel tick by tick up to tick (inclusive) - expired tasks are passed to on_expired(Task&&)
+        template <typename OnExpired>
+        void advance_to(Tick tick, OnExpired&& on_expired)
+        {
+            if (size_ == 0) // nothing to cascade or fire
+            {
+                now_ = std::max(now_, tick);
+                return;
+            }
+
+            while (now_ < tick)
+            {
+                ++now_;
+
+                if ((now_ & slot_mask) == 0)
+                    cascade();
+
+                fire(now_ & slot_mask, on_expired);
+
+                if (size_ == 0)
+                {
+                    now_ = tick;
+                    return;
+                }
+            }
+        }
+
+    private:
+        std::vector<Node> nodes_;
+        std::uint32_t free_list_ = nil;
+        std::array<std::uint32_t, level_count * slot_count> heads_ = make_empty_heads();
+        Tick now_ = 0;
+        std::size_t size_ = 0;
+
+        static constexpr std::array<std::uint32_t, level_count * slot_count> make_empty_heads()
+        {
+            std::array<std::uint32_t, level_count * slot_count> heads{};
+            heads.fill(nil);
+            return heads;
+        }
+
+        std::uint32_t allocate_node()
+        {
+            if (free_list_ == nil)
+            {
+                nodes_.emplace_back();
+                return static_cast<std::uint32_t>(nodes_.size() - 1);
+            }
+
+            const std::uint32_t index = free_list_;
+            free_list_ = nodes_[index].next;
+            return index;
+        }
+
+        void release_node(std::uint32_t index)
+        {
+            Node& node = nodes_[index];
+            node.task.reset();
+            node.periodic.reset();
+            node.slot = nil;
+            ++node.generation; // ids of the released timer become stale
+            node.next = free_list_;
+            free_list_ = index;
+        }
+
+        // earliest - now_ + 1 for new timers, now_ for cascaded ones (the current slot fires after cascading)
+        std::uint32_t slot_of(Tick expiry, Tick earliest) const noexcept
+        {
+            expiry = std::max(expiry, earliest);
+
+            const Tick delta = std::min(expiry - now_, max_delta);
+            const Tick clamped_expiry = now_ + delta;
+
+            std::size_t level = 0;
+            while (level + 1 < level_count && delta >= (Tick{1} << (slot_bits * (level + 1))))
+                ++level;
+
+            return static_cast<std::uint32_t>(level * slot_count + ((clamped_expiry >> (slot_bits * level)) & slot_mask));
+        }
+
+        void link(std::uint32_t index, Tick earliest)
+        {
+            Node& node = nodes_[index];
+            node.slot = slot_of(node.expiry, earliest);
+            node.prev = nil;
+            node.next = heads_[node.slot];
+
+            if (node.next != nil)
+                nodes_[node.next].prev = index;
+            heads_[node.slot] = index;
+        }
+
+        void unlink(std::uint32_t index)
+        {
+            Node& node = nodes_[index];
+
+            if (node.prev != nil)
+                nodes_[node.prev].next = node.next;
+            else
+                heads_[node.slot] = node.next;
+
+            if (node.next != nil)
+                nodes_[node.next].prev = node.prev;
+        }
+
+        // moves timers of the current slots of upper levels one level down
+        void cascade()
+        {
+            for (std::size_t level = 1; level < level_count; ++level)
+            {
+                const std::size_t slot_index = (now_ >> (slot_bits * level)) & slot_mask;
+                const std::size_t slot = level * slot_count + slot_index;
+
+                std::uint32_t index = std::exchange(heads_[slot], nil);
+                while (index != nil)
+                {
+                    const std::uint32_t next = nodes_[index].next;
+                    link(index, now_);
+                    index = next;
+                }
+
+                if (slot_index != 0)
+                    break;
+            }
+        }
+
+        template <typename OnExpired>
+        void fire(std::size_t slot, OnExpired& on_expired)
+        {
+            std::uint32_t index = std::exchange(heads_[slot], nil);
+
+            while (index != nil)
+            {
+                Node& node = nodes_[index];
+                const std::uint32_t next = node.next;
+
+                if (node.expiry > now_) // clamped far timer - not expired yet
+                    link(index, now_ + 1);
+                else if (node.period > 0)
+                {
+                    if (!node.periodic->in_flight.exchange(true, std::memory_order_acquire)) // otherwise this expiry is skipped
+                        on_expired(Task{Detail::PeriodicFiring{node.periodic}});
+                    node.expiry = std::max(node.expiry + node.period, now_ + 1);
+                    link(index, now_ + 1);
+                }
+                else
+                {
+                    on_expired(std::move(node.task));
+                    release_node(index);
+                    --size_;
+                }
+
+                index = next;
+            }
+        }
+    };
+
+    // single thread driving a timing wheel - expired tasks are passed to dispatch(Task)
+    class TimerService
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Dispatch = Executors::UniqueFunction<void(Task)>;
+
+        explicit TimerService(Dispatch dispatch, Clock::duration resolution = std::chrono::milliseconds{1})
+            : dispatch_{std::move(dispatch)}
+            , resolution_{resolution}
+            , thread_{[this](std::stop_token stop) { timer_loop(stop); }}
+        {
+        }
+
+        TimerService(const TimerService&) = delete;
+        TimerService& operator=(const TimerService&) = delete;
+
+        // pending timers are dropped
+        ~TimerService()
+        {
+            thread_.request_stop();
+            thread_.join();
+        }
+
+        TimerId schedule_at(Clock::time_point deadline, Task task)
+        {
+            return schedule(deadline, std::move(task), 0);
+        }
+
+        TimerId schedule_after(Clock::duration delay, Task task)
+        {
+            return schedule(Clock::now() + delay, std::move(task), 0);
+        }
+
+        TimerId schedule_every(Clock::duration period, Task task)
+        {
+            const Tick period_ticks = std::max<Tick>(1, ticks_ceil(period));
+            return schedule(Clock::now() + period, std::move(task), period_ticks);
+        }
+
+        bool cancel(TimerId id)
+        {
+            std::lock_guard lk{mtx_};
+            return wheel_.cancel(id);
+        }
+
+        std::size_t pending() const
+        {
+            std::lock_guard lk{mtx_};
+            return wheel_.size();
+        }
+
+    private:
+        Dispatch dispatch_;
+        const Clock::duration resolution_;
+        const Clock::time_point start_ = Clock::now();
+
+        mutable std::mutex mtx_;
+        std::condition_variable_any cv_timers_;
+        TimingWheel wheel_;
+        std::jthread thread_;
+
+        Tick current_tick() const
+        {
+            return static_cast<Tick>((Clock::now() - start_) / resolution_);
+        }
+
+        Tick ticks_ceil(Clock::duration duration) const
+        {
+            return static_cast<Tick>((duration + resolution_ - Clock::duration{1}) / resolution_);
+        }
+
+        TimerId schedule(Clock::time_point deadline, Task task, Tick period)
+        {
+            const Tick expiry = deadline > start_ ? ticks_ceil(deadline - start_) : 0;
+
+            bool was_empty;
+            TimerId id;
+            {
+                std::lock_guard lk{mtx_};
+                was_empty = wheel_.empty();
+                if (was_empty) // the wheel isn't advanced while empty - skip the idle ticks
+                    wheel_.advance_to(current_tick(), [](Task&&) {});
+                id = wheel_.insert(expiry, std::move(task), period);
+            }
+
+            if (was_empty)
+                cv_timers_.notify_one();
+
+            return id;
+        }
+
+        void timer_loop(std::stop_token stop)
+        {
+            std::vector<Task> expired;
+            std::unique_lock lk{mtx_};
+
+            while (!stop.stop_requested())
+            {
+                if (!cv_timers_.wait(lk, stop, [this] { return !wheel_.empty(); }))
+                    return;
+
+                const Tick current = current_tick();
+                wheel_.advance_to(current, [&expired](Task&& task) { expired.push_back(std::move(task)); });
+
+                if (!expired.empty())
+                {
+                    lk.unlock();
+                    for (auto& task : expired)
+                        dispatch_(std::move(task));
+                    expired.clear();
+                    lk.lock();
+                }
+
+                cv_timers_.wait_until(lk, stop, start_ + (current + 1) * resolution_, [] { return false; });
+            }
+        }
+    };
+} // namespace Timers
+
+#endif
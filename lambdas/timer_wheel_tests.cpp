@@ -0,0 +1,285 @@
+#include "task_queue.hpp"
+#include "timer_wheel.hpp"
+
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Timers::Tick;
+using Timers::TimingWheel;
+
+namespace
+{
+    // ticks in which the timers fired
+    struct FiringLog
+    {
+        std::vector<std::pair<int, Tick>> fired;
+
+        void advance(TimingWheel& wheel, Tick tick)
+        {
+            while (wheel.now() < tick)
+                wheel.advance_to(wheel.now() + 1, [](Timers::Task&& task) { task(); });
+        }
+
+        Timers::Task timer(TimingWheel& wheel, int id)
+        {
+            return [this, &wheel, id] { fired.emplace_back(id, wheel.now()); };
+        }
+    };
+} // namespace
+
+TEST_CASE("TimingWheel")
+{
+    TimingWheel wheel;
+    FiringLog log;
+
+    SECTION("timers fire at their expiry tick - also after cascading from upper levels")
+    {
+        for (Tick expiry : {Tick{20'000'000}, Tick{70'000}, Tick{300}, Tick{256}, Tick{5}})
+            wheel.insert(expiry, log.timer(wheel, static_cast<int>(expiry)));
+        CHECK(wheel.size() == 5);
+
+        log.advance(wheel, 20'000'000);
+
+        using Fired = std::vector<std::pair<int, Tick>>;
+        CHECK(log.fired == Fired{{5, 5}, {256, 256}, {300, 300}, {70'000, 70'000}, {20'000'000, 20'000'000}});
+        CHECK(wheel.empty());
+    }
+
+    SECTION("expired timer fires on the next tick")
+    {
+        log.advance(wheel, 10);
+        wheel.insert(3, log.timer(wheel, 1));
+
+        log.advance(wheel, 20);
+
+        CHECK(log.fired == std::vector<std::pair<int, Tick>>{{1, 11}});
+    }
+
+    SECTION("cancelled timer doesn't fire")
+    {
+        auto first = wheel.insert(10, log.timer(wheel, 1));
+        auto second = wheel.insert(10, log.timer(wheel, 2));
+        auto third = wheel.insert(10, log.timer(wheel, 3));
+
+        CHECK(wheel.cancel(second));
+        CHECK_FALSE(wheel.cancel(second));
+
+        log.advance(wheel, 10);
+
+        CHECK(log.fired.size() == 2);
+        CHECK_FALSE(wheel.cancel(first)); // already fired
+        CHECK_FALSE(wheel.cancel(third));
+    }
+
+    SECTION("id of a fired timer doesn't cancel a timer reusing its node")
+    {
+        auto fired = wheel.insert(1, log.timer(wheel, 1));
+        log.advance(wheel, 1);
+
+        auto reused = wheel.insert(5, log.timer(wheel, 2));
+        CHECK(reused.index == fired.index);
+        CHECK_FALSE(wheel.cancel(fired));
+
+        log.advance(wheel, 5);
+        CHECK(log.fired.size() == 2);
+    }
+
+    SECTION("periodic timer fires until cancelled")
+    {
+        auto id = wheel.insert(100, log.timer(wheel, 1), 100);
+
+        log.advance(wheel, 1'000);
+        CHECK(log.fired.size() == 10);
+        CHECK(log.fired.back().second == 1'000);
+
+        CHECK(wheel.cancel(id));
+        log.advance(wheel, 2'000);
+        CHECK(log.fired.size() == 10);
+    }
+
+    SECTION("periodic timer isn't fired while its previous firing is in flight")
+    {
+        int count = 0;
+        wheel.insert(10, [&count] { ++count; }, 10);
+
+        std::vector<Timers::Task> dispatched;
+        auto dispatch = [&dispatched](Timers::Task&& task) { dispatched.push_back(std::move(task)); };
+
+        wheel.advance_to(50, dispatch);
+        REQUIRE(dispatched.size() == 1); // expiries at 20..50 are skipped
+
+        dispatched.front()();
+        CHECK(count == 1);
+
+        wheel.advance_to(60, dispatch);
+        REQUIRE(dispatched.size() == 2);
+
+        dispatched.clear(); // dropped firing doesn't stop the timer
+        wheel.advance_to(70, dispatch);
+        CHECK(dispatched.size() == 1);
+    }
+
+    SECTION("timers fire in the order of expiries - not insertion")
+    {
+        wheel.insert(20, log.timer(wheel, 20));
+        wheel.insert(5, log.timer(wheel, 5));
+        wheel.insert(12, log.timer(wheel, 12), 7);
+
+        log.advance(wheel, 27);
+
+        CHECK(log.fired == std::vector<std::pair<int, Tick>>{{5, 5}, {12, 12}, {12, 19}, {20, 20}, {12, 26}});
+    }
+
+    SECTION("advancing an empty wheel jumps")
+    {
+        wheel.advance_to(1'000'000'000, [](Timers::Task&&) {});
+        CHECK(wheel.now() == 1'000'000'000);
+    }
+}
+
+namespace
+{
+    // runs q until done() or a generous timeout - timing of the timer thread isn't checked
+    template <typename Queue, typename Done>
+    bool run_until_done(Queue& q, Done done)
+    {
+        const auto timeout = TaskQueue::Clock::now() + 10s;
+        while (!done() && TaskQueue::Clock::now() < timeout)
+            q.run_for(1ms);
+        return done();
+    }
+} // namespace
+
+TEST_CASE("TaskQueue - delayed & periodic tasks")
+{
+    TaskQueue q;
+
+    SECTION("delayed tasks run")
+    {
+        int count = 0;
+        q.post_after(1ms, [&count] { ++count; });
+        q.post_at(TaskQueue::Clock::now() - 1s, [&count] { ++count; }); // deadline in the past
+
+        CHECK(run_until_done(q, [&count] { return count == 2; }));
+    }
+
+    SECTION("cancelled task doesn't run")
+    {
+        bool run = false;
+        auto id = q.post_after(1h, [&run] { run = true; });
+
+        CHECK(q.cancel(id));
+        CHECK_FALSE(q.cancel(id));
+        q.run();
+        CHECK_FALSE(run);
+    }
+
+    SECTION("periodic task runs until cancelled")
+    {
+        int count = 0;
+        auto id = q.post_every(1ms, [&count] { ++count; });
+
+        REQUIRE(run_until_done(q, [&count] { return count >= 3; }));
+        CHECK(q.cancel(id));
+
+        const int cancelled_at = count;
+        q.run_for(20ms);
+        CHECK(count <= cancelled_at + 1); // a firing may already be dispatched
+    }
+}
+
+TEST_CASE("ConcurrentTaskQueue - expired timers don't block run() on a full queue")
+{
+    ConcurrentTaskQueue q{4};
+    std::atomic<int> count = 0;
+
+    for (int i = 0; i < 4; ++i)
+        q.post([&count] { ++count; });
+    q.post_after(0ms, [&count] { ++count; });
+    std::this_thread::sleep_for(20ms); // the timer expires while the queue is full
+
+    CHECK(run_until_done(q, [&count] { return count == 5; }));
+}
+
+TEST_CASE("TimingWheel - benchmark", "[.benchmark]")
+{
+    const int count = 1'000'000;
+
+    std::mt19937_64 rnd{665};
+    std::uniform_int_distribution<Tick> expiries{1, 10'000'000}; // ~2.8 hours at 1 ms ticks
+    std::vector<Tick> expiry(count);
+    for (auto& e : expiry)
+        e = expiries(rnd);
+
+    BENCHMARK_ADVANCED("TimingWheel - insert & cancel 1M timers")(Catch::Benchmark::Chronometer meter)
+    {
+        TimingWheel wheel;
+        std::vector<Timers::TimerId> ids(count);
+
+        meter.measure([&] {
+            for (int i = 0; i < count; ++i)
+                ids[i] = wheel.insert(expiry[i], [] {});
+            for (int i = 0; i < count; ++i)
+                wheel.cancel(ids[i]);
+            return wheel.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("std::multimap - insert & erase 1M timers")(Catch::Benchmark::Chronometer meter)
+    {
+        std::multimap<Tick, Timers::Task> timers;
+        std::vector<std::multimap<Tick, Timers::Task>::iterator> ids(count);
+
+        meter.measure([&] {
+            for (int i = 0; i < count; ++i)
+                ids[i] = timers.emplace(expiry[i], [] {});
+            for (int i = 0; i < count; ++i)
+                timers.erase(ids[i]);
+            return timers.size();
+        });
+    };
+}
+
+TEST_CASE("TaskQueue - timer jitter with 1M outstanding timers", "[.benchmark]")
+{
+    TaskQueue q;
+    q.sample_every(0);
+
+    const int count = 1'000'000;
+    const int fired_count = 10'000; // the rest stay pending an hour ahead
+
+    Metrics::Histogram lateness;
+    auto record_lateness = [&lateness](TaskQueue::Clock::time_point deadline) {
+        return [&lateness, deadline] { lateness.record(static_cast<Metrics::Nanoseconds>((TaskQueue::Clock::now() - deadline) / 1ns)); };
+    };
+
+    const auto start = TaskQueue::Clock::now();
+    for (int i = fired_count; i < count; ++i)
+        q.post_at(start + 1h, record_lateness(start + 1h));
+    const auto inserted = TaskQueue::Clock::now();
+
+    std::mt19937_64 rnd{665};
+    std::uniform_int_distribution<int> delays_ms{100, 2'000};
+    for (int i = 0; i < fired_count; ++i)
+    {
+        const auto deadline = inserted + 1ms * delays_ms(rnd);
+        q.post_at(deadline, record_lateness(deadline));
+    }
+
+    q.run_until(inserted + 2'100ms);
+
+    std::cout << "inserting 1M timers: " << (inserted - start) / 1ms << " ms\n"
+              << "fired: " << lateness.count() << ", lateness [us]: p50=" << lateness.percentile(0.5) / 1'000
+              << " p90=" << lateness.percentile(0.9) / 1'000 << " p99=" << lateness.percentile(0.99) / 1'000
+              << " p99.9=" << lateness.percentile(0.999) / 1'000 << " max=" << lateness.max() / 1'000 << "\n";
+
+    CHECK(lateness.count() == fired_count);
+}
@@ -0,0 +1,192 @@
+#ifndef UNIQUE_FUNCTION_HPP
+#define UNIQUE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// UniqueFunction - move-only std::function with a configurable inline buffer
+//
+// UniqueFunction<void(), 64> task = [ptr = std::make_unique<Gadget>()] { ptr->use(); };
+//
+// - callables up to BufferSize bytes (nothrow movable) are stored inline - no allocation
+// - larger callables are allocated on the heap - moving the function moves only a pointer
+// - move-only captures (unique_ptr, promise, ...) are accepted
+// - null function & member pointers, empty std::function (or UniqueFunction) give an empty function
+
+namespace Executors
+{
+    template <typename Signature, std::size_t BufferSize = 48>
+    class UniqueFunction;
+
+    namespace Detail
+    {
+        template <typename F>
+        struct IsFunctionWrapper : std::false_type
+        {
+        };
+
+        template <typename Signature>
+        struct IsFunctionWrapper<std::function<Signature>> : std::true_type
+        {
+        };
+
+        template <typename Signature, std::size_t BufferSize>
+        struct IsFunctionWrapper<UniqueFunction<Signature, BufferSize>> : std::true_type
+        {
+        };
+
+        // f is a null pointer or an empty function wrapper
+        template <typename F>
+        bool is_null_callable(const F& f) noexcept
+        {
+            if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F>)
+                return f == nullptr;
+            else if constexpr (IsFunctionWrapper<F>::value)
+                return !f;
+            else
+                return false;
+        }
+    } // namespace Detail
+
+    template <typename R, typename... Args, std::size_t BufferSize>
+    class UniqueFunction<R(Args...), BufferSize>
+    {
+        static_assert(BufferSize >= sizeof(void*), "Buffer must fit a pointer");
+
+        struct VTable
+        {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*move)(void* target, void* source) noexcept; // moves & destroys the source
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <typename F>
+        static constexpr bool is_stored_inline = sizeof(F) <= BufferSize
+            && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+        template <typename F>
+        static F& target(void* storage) noexcept
+        {
+            if constexpr (is_stored_inline<F>)
+                return *std::launder(static_cast<F*>(storage));
+            else
+                return **std::launder(static_cast<F**>(storage));
+        }
+
+        template <typename F>
+        static constexpr VTable vtable_for{
+            [](void* storage, Args&&... args) -> R {
+                if constexpr (std::is_void_v<R>) // a result of the callable is discarded
+                    std::invoke(target<F>(storage), std::forward<Args>(args)...);
+                else
+                    return std::invoke(target<F>(storage), std::forward<Args>(args)...);
+            },
+            [](void* target_storage, void* source_storage) noexcept {
+                if constexpr (is_stored_inline<F>)
+                {
+                    F& source = target<F>(source_storage);
+                    ::new (target_storage) F(std::move(source));
+                    source.~F();
+                }
+                else
+                    ::new (target_storage) F*(*std::launder(static_cast<F**>(source_storage)));
+            },
+            [](void* storage) noexcept {
+                if constexpr (is_stored_inline<F>)
+                    target<F>(storage).~F();
+                else
+                    delete &target<F>(storage);
+            }};
+
+        alignas(std::max_align_t) std::byte storage_[BufferSize];
+        const VTable* vtable_ = nullptr;
+
+    public:
+        static constexpr std::size_t buffer_size = BufferSize;
+
+        UniqueFunction() noexcept = default;
+
+        UniqueFunction(std::nullptr_t) noexcept
+        {
+        }
+
+        template <typename F>
+            requires(!std::is_same_v<std::remove_cvref_t<F>, UniqueFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        UniqueFunction(F&& f)
+        {
+            using Fn = std::decay_t<F>;
+
+            if constexpr (!std::is_function_v<std::remove_reference_t<F>>) // a function reference is never null
+                if (Detail::is_null_callable<std::remove_cvref_t<F>>(f))
+                    return;
+
+            if constexpr (is_stored_inline<Fn>)
+                ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+            else
+                ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(f)));
+
+            vtable_ = &vtable_for<Fn>;
+        }
+
+        UniqueFunction(const UniqueFunction&) = delete;
+        UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+        UniqueFunction(UniqueFunction&& other) noexcept
+            : vtable_{other.vtable_}
+        {
+            if (vtable_)
+            {
+                vtable_->move(storage_, other.storage_);
+                other.vtable_ = nullptr;
+            }
+        }
+
+        UniqueFunction& operator=(UniqueFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+
+                if (other.vtable_)
+                {
+                    other.vtable_->move(storage_, other.storage_);
+                    vtable_ = std::exchange(other.vtable_, nullptr);
+                }
+            }
+
+            return *this;
+        }
+
+        ~UniqueFunction()
+        {
+            reset();
+        }
+
+        R operator()(Args... args)
+        {
+            if (!vtable_)
+                throw std::bad_function_call();
+
+            return vtable_->invoke(storage_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return vtable_ != nullptr;
+        }
+
+        void reset() noexcept
+        {
+            if (vtable_)
+                std::exchange(vtable_, nullptr)->destroy(storage_);
+        }
+    };
+} // namespace Executors
+
+#endif
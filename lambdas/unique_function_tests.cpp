@@ -0,0 +1,214 @@
+#include "task_queue.hpp"
+#include "unique_function.hpp"
+
+#include <alloc_tracker.hpp>
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+using Executors::UniqueFunction;
+
+TEST_CASE("UniqueFunction")
+{
+    SECTION("small callable is stored inline")
+    {
+        int x = 0;
+
+        AllocTracker::Scope scope;
+        UniqueFunction<void(int)> f = [&x](int value) { x = value; };
+        UniqueFunction<void(int)> g = std::move(f);
+        g(42);
+
+        CHECK(x == 42);
+        CHECK_FALSE(f);
+        CHECK(scope.allocations() == 0);
+    }
+
+    SECTION("move-only captures")
+    {
+        UniqueFunction<int()> f = [ptr = std::make_unique<int>(665)] { return *ptr; };
+        CHECK(f() == 665);
+    }
+
+    SECTION("large callable is allocated once - moves don't allocate")
+    {
+        std::array<char, 128> large{};
+        large[0] = 'a';
+
+        AllocTracker::Scope scope;
+        UniqueFunction<char()> f = [large] { return large[0]; };
+        UniqueFunction<char()> g = std::move(f);
+        UniqueFunction<char()> h;
+        h = std::move(g);
+
+        CHECK(h() == 'a');
+        CHECK(scope.allocations() == 1);
+    }
+
+    SECTION("buffer size is configurable")
+    {
+        std::array<char, 128> large{};
+
+        AllocTracker::Scope scope;
+        UniqueFunction<std::size_t(), 128> f = [large] { return large.size(); };
+
+        CHECK(f() == 128);
+        CHECK(scope.allocations() == 0);
+    }
+
+    SECTION("result is discarded by a void signature - like std::function")
+    {
+        int calls = 0;
+        UniqueFunction<void()> f = [&calls] { return ++calls; };
+        f();
+        CHECK(calls == 1);
+
+        TaskQueue q;
+        q.post([&calls] { return ++calls; });
+        q.run();
+        CHECK(calls == 2);
+    }
+
+    SECTION("destroys the callable")
+    {
+        auto ptr = std::make_shared<int>(1);
+        {
+            UniqueFunction<void()> f = [ptr] {};
+            CHECK(ptr.use_count() == 2);
+        }
+        CHECK(ptr.use_count() == 1);
+    }
+
+    SECTION("empty function throws")
+    {
+        UniqueFunction<void()> f;
+        CHECK_THROWS_AS(f(), std::bad_function_call);
+    }
+
+    SECTION("null pointers & empty wrappers give an empty function")
+    {
+        struct Gadget
+        {
+            int id() const
+            {
+                return 42;
+            }
+        };
+
+        int (*null_function)() = nullptr;
+        int (Gadget::*null_member)() const = nullptr;
+
+        UniqueFunction<int()> from_function_ptr = null_function;
+        UniqueFunction<int(const Gadget&)> from_member_ptr = null_member;
+        UniqueFunction<int()> from_std_function = std::function<int()>{};
+        UniqueFunction<int(), 64> from_unique_function = UniqueFunction<int()>{};
+
+        CHECK_FALSE(from_function_ptr);
+        CHECK_FALSE(from_member_ptr);
+        CHECK_FALSE(from_std_function);
+        CHECK_FALSE(from_unique_function);
+        CHECK_THROWS_AS(from_function_ptr(), std::bad_function_call);
+
+        UniqueFunction<int(const Gadget&)> member = &Gadget::id;
+        REQUIRE(member);
+        CHECK(member(Gadget{}) == 42);
+    }
+}
+
+TEST_CASE("TaskQueue - move-only tasks")
+{
+    TaskQueue q;
+    std::vector<int> results;
+
+    q.submit([ptr = std::make_unique<int>(1), &results] { results.push_back(*ptr); });
+    q.submit([ptr = std::make_unique<int>(2), &results] { results.push_back(*ptr); });
+    q.run();
+
+    CHECK(results == std::vector{1, 2});
+}
+
+namespace
+{
+    // previous version of TaskQueue - std::function copied in & out
+    class StdFunctionQueue
+    {
+    public:
+        using Task = std::function<void()>;
+
+        std::queue<Task> q_tasks_;
+
+        void post(const Task& t)
+        {
+            q_tasks_.push(t);
+        }
+
+        void run()
+        {
+            while (!q_tasks_.empty())
+            {
+                Task task = q_tasks_.front();
+                q_tasks_.pop();
+                task();
+            }
+        }
+    };
+
+    template <std::size_t CaptureSize, typename Queue>
+    std::size_t submit_and_run(Queue& q, int count)
+    {
+        std::array<char, CaptureSize> capture{};
+        std::size_t sum = 0;
+
+        for (int i = 0; i < count; ++i)
+            q.post([capture, &sum] { sum += capture.size(); });
+        q.run();
+
+        return sum;
+    }
+
+    template <std::size_t CaptureSize>
+    void benchmark_capture_size()
+    {
+        const int count = 10'000;
+        const std::string suffix = " - capture " + std::to_string(CaptureSize) + " B";
+
+        StdFunctionQueue std_queue;
+        TaskQueue task_queue;
+
+        {
+            AllocTracker::Scope scope;
+            submit_and_run<CaptureSize>(std_queue, count);
+            std::cout << "std::function" << suffix << ": " << static_cast<double>(scope.allocations()) / count << " allocations/task\n";
+        }
+
+        {
+            AllocTracker::Scope scope;
+            submit_and_run<CaptureSize>(task_queue, count);
+            std::cout << "UniqueFunction" << suffix << ": " << static_cast<double>(scope.allocations()) / count << " allocations/task\n";
+        }
+
+        BENCHMARK("std::function" + suffix)
+        {
+            return submit_and_run<CaptureSize>(std_queue, count);
+        };
+
+        BENCHMARK("UniqueFunction" + suffix)
+        {
+            return submit_and_run<CaptureSize>(task_queue, count);
+        };
+    }
+} // namespace
+
+TEST_CASE("TaskQueue - submit & run benchmark", "[.benchmark]")
+{
+    benchmark_capture_size<8>();
+    benchmark_capture_size<32>();
+    benchmark_capture_size<64>();
+    benchmark_capture_size<128>();
+}
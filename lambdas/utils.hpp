@@ -1,4 +1,5 @@
 #include <iostream>
+#include <lifecycle.hpp>
 #include <string>
 #include <string_view>
 
@@ -19,6 +20,7 @@ namespace Utils
     {
         int id_;
         std::string name_;
+        [[no_unique_address]] Lifecycle::Counter<Gadget> lifecycle_;
 
     public:
         static int gen_id()
@@ -49,6 +51,7 @@ namespace Utils
         Gadget(const Gadget& source)
             : id_ {source.id_}
             , name_ {source.name_}
+            , lifecycle_ {source.lifecycle_}
         {
             std::cout << "Gadget(cc: " << id_ << ", " << name_ << ")" << std::endl;
         }
@@ -59,6 +62,7 @@ namespace Utils
             {
                 id_ = source.id_;
                 name_ = source.name_;
+                lifecycle_ = source.lifecycle_;
 
                 std::cout << "Gadget::operator=(cpy: " << id_ << ", " << name_ << ")" << std::endl;
             }
@@ -71,6 +75,7 @@ namespace Utils
         Gadget(Gadget&& source) noexcept
             : id_ {source.id_}
             , name_ {std::move(source.name_)}
+            , lifecycle_ {std::move(source.lifecycle_)}
         {
             if (this != &source)
             {
@@ -84,6 +89,7 @@ namespace Utils
             {
                 id_ = source.id_;
                 name_ = std::move(source.name_);
+                lifecycle_ = std::move(source.lifecycle_);
 
                 std::cout << "Gadget::operator=(mv: " << id_ << ", " << name_ << ")" << std::endl;
             }
@@ -2,6 +2,7 @@
 #define GADGET_HPP
 
 #include <iostream>
+#include <lifecycle.hpp>
 #include <string>
 
 namespace Helpers
@@ -10,6 +11,7 @@ namespace Helpers
     {
         int id{};
         std::string name{"not-set"};
+        [[no_unique_address]] Lifecycle::Counter<Gadget> lifecycle;
 
         Gadget() = default;
 
@@ -1,10 +1,26 @@
 #include "gadget.hpp"
+#include "quantiles.hpp"
+#include "sort_keys.hpp"
+#include "statistics.hpp"
 
 #include <algorithm>
+#include <alloc_tracker.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <iostream>
+#include <limits>
 #include <memory>
 #include <numeric>
+#include <random>
+#include <relocation.hpp>
+#include <thread>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 ////////////////////////////////////////////////
 // simplified implementation of unique_ptr - only moveable type
@@ -109,6 +125,12 @@ namespace Explain
     // }
 } // namespace Explain
 
+// UniquePtr is a single owning pointer - it can be relocated with memcpy
+template <typename T>
+struct Relocation::is_trivially_relocatable<Explain::UniquePtr<T>> : std::true_type
+{
+};
+
 struct TestDestructor
 {
     std::function<void()> callback_;
@@ -204,6 +226,133 @@ TEST_CASE("move semantics - unique_ptr")
     } // call of UniquePtr destructor - free mem
 }
 
+TEST_CASE("relocation - vector of UniquePtr")
+{
+    using namespace Explain;
+
+    static_assert(Relocation::is_trivially_relocatable_v<UniquePtr<Gadget>>);
+    static_assert(Relocation::is_trivially_relocatable_v<std::unique_ptr<Gadget>>);
+    static_assert(!Relocation::is_trivially_relocatable_v<std::string>);
+
+    Relocation::Vector<UniquePtr<Gadget>> gadgets;
+    for (int i = 1; i <= 10; ++i)
+        gadgets.push_back(MakeUnique<Gadget>(i, "gadget"));
+
+    CHECK(gadgets.size() == 10);
+    CHECK(gadgets.capacity() >= 10);
+
+    gadgets.erase(gadgets.begin() + 3);
+
+    CHECK(gadgets.size() == 9);
+    CHECK(gadgets[2]->id == 3);
+    CHECK(gadgets[3]->id == 5);
+    CHECK(gadgets.back()->id == 10);
+}
+
+namespace
+{
+    // copy throws once the budget of copies is spent
+    struct LimitedCopies
+    {
+        inline static int copies_left = 0;
+
+        std::string name;
+
+        explicit LimitedCopies(std::string n)
+            : name{std::move(n)}
+        {
+        }
+
+        LimitedCopies(const LimitedCopies& other)
+            : name{other.name}
+        {
+            if (copies_left-- <= 0)
+                throw std::runtime_error("No copies left");
+        }
+
+        LimitedCopies& operator=(const LimitedCopies&) = default;
+    };
+} // namespace
+
+TEST_CASE("relocation - vector construction is exception safe")
+{
+    const std::string long_name(64, 'x'); // allocated - a leaked item shows up in the counters
+
+    SECTION("copy constructor")
+    {
+        LimitedCopies::copies_left = 3;
+        Relocation::Vector<LimitedCopies> source{LimitedCopies{long_name}, LimitedCopies{long_name}, LimitedCopies{long_name}};
+
+        AllocTracker::Scope scope;
+        LimitedCopies::copies_left = 2;
+        CHECK_THROWS_AS(Relocation::Vector<LimitedCopies>(source), std::runtime_error);
+        CHECK(scope.allocations() == scope.deallocations());
+    }
+
+    SECTION("initializer list")
+    {
+        AllocTracker::Scope scope;
+        LimitedCopies::copies_left = 1;
+        CHECK_THROWS_AS((Relocation::Vector<LimitedCopies>{LimitedCopies{long_name}, LimitedCopies{long_name}}), std::runtime_error);
+        CHECK(scope.allocations() == scope.deallocations());
+    }
+}
+
+TEST_CASE("relocation - benchmark", "[.benchmark]")
+{
+    using namespace Explain;
+
+    const int size = 1'000'000;
+
+    BENCHMARK("std::vector<UniquePtr<int>> - growth")
+    {
+        std::vector<UniquePtr<int>> vec;
+        for (int i = 0; i < size; ++i)
+            vec.push_back(MakeUnique<int>(i));
+        return vec.size();
+    };
+
+    BENCHMARK("Relocation::Vector<UniquePtr<int>> - growth")
+    {
+        Relocation::Vector<UniquePtr<int>> vec;
+        for (int i = 0; i < size; ++i)
+            vec.push_back(MakeUnique<int>(i));
+        return vec.size();
+    };
+
+    const int erase_size = 100'000;
+
+    BENCHMARK_ADVANCED("std::vector<UniquePtr<int>> - erase in the middle")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::vector<UniquePtr<int>>> vecs(meter.runs());
+        for (auto& vec : vecs)
+            for (int i = 0; i < erase_size; ++i)
+                vec.push_back(MakeUnique<int>(i));
+
+        meter.measure([&vecs](int run) {
+            auto& vec = vecs[run];
+            for (int i = 0; i < 1000; ++i)
+                vec.erase(vec.begin() + vec.size() / 2);
+            return vec.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Relocation::Vector<UniquePtr<int>> - erase in the middle")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Relocation::Vector<UniquePtr<int>>> vecs(meter.runs());
+        for (auto& vec : vecs)
+            for (int i = 0; i < erase_size; ++i)
+                vec.push_back(MakeUnique<int>(i));
+
+        meter.measure([&vecs](int run) {
+            auto& vec = vecs[run];
+            for (int i = 0; i < 1000; ++i)
+                vec.erase(vec.begin() + vec.size() / 2);
+            return vec.size();
+        });
+    };
+}
+
 struct X
 {
     int a;
@@ -255,6 +404,138 @@ TEST_CASE("compare")
     CHECK(x1 < x2);
 }
 
+std::vector<X> create_random_records(size_t size, const std::string& prefix = "", unsigned int seed = 665)
+{
+    std::mt19937_64 rnd_gen(seed);
+    std::uniform_int_distribution<int> rnd_int(-1000, 1000);
+    std::uniform_real_distribution<double> rnd_double(-10.0, 10.0);
+    std::uniform_int_distribution<int> rnd_char('a', 'z');
+    std::uniform_int_distribution<size_t> rnd_length(0, 24);
+
+    std::vector<X> records(size);
+    for (auto& x : records)
+    {
+        x.a = rnd_int(rnd_gen);
+        x.b = std::round(rnd_double(rnd_gen)); // many ties on (a, b) - order decided by strings
+        x.s = prefix;
+        std::generate_n(std::back_inserter(x.s), rnd_length(rnd_gen), [&] { return static_cast<char>(rnd_char(rnd_gen)); });
+    }
+
+    return records;
+}
+
+TEST_CASE("sort keys - radix sort of tied() records")
+{
+    SECTION("keys preserve order")
+    {
+        X x1{-1, 3.14, "pi"};
+        X x2{1, -3.14, "pi"};
+        X x3{1, -0.0, "e"};
+        X x4{1, 0.0, "pi"};
+
+        std::array<std::byte, 4 + 8 + 16> k1, k2, k3, k4;
+        SortKeys::encode_key<16>(k1.data(), x1.tied());
+        SortKeys::encode_key<16>(k2.data(), x2.tied());
+        SortKeys::encode_key<16>(k3.data(), x3.tied());
+        SortKeys::encode_key<16>(k4.data(), x4.tied());
+
+        CHECK(k1 < k2);
+        CHECK(k2 < k3);
+        CHECK(k3 < k4);
+    }
+
+    SECTION("same order as std::sort")
+    {
+        std::vector<X> records = create_random_records(100'000);
+        std::vector<X> expected = records;
+
+        std::sort(expected.begin(), expected.end());
+        SortKeys::radix_sort(records.begin(), records.end());
+
+        CHECK(records == expected);
+    }
+
+    SECTION("strings longer than key prefix")
+    {
+        std::vector<X> records = create_random_records(100'000, "shared-prefix-");
+        std::vector<X> expected = records;
+
+        std::sort(expected.begin(), expected.end());
+        SortKeys::radix_sort<4>(records.begin(), records.end());
+
+        CHECK(records == expected);
+    }
+}
+
+struct NamedValue
+{
+    std::string name;
+    int value;
+
+    auto tied() const
+    {
+        return std::tie(name, value);
+    }
+
+    bool operator==(const NamedValue& other) const
+    {
+        return tied() == other.tied();
+    }
+
+    bool operator<(const NamedValue& other) const
+    {
+        return tied() < other.tied();
+    }
+};
+
+TEST_CASE("sort keys - string followed by other fields")
+{
+    using namespace std::literals;
+
+    SECTION("strings cut to the same prefix are ordered by the whole string")
+    {
+        std::vector<NamedValue> records{{"aaaab", 5}, {"aaaaz", 1}, {"ab\0"s, 0}, {"ab", 7}, {"aaaa", 9}};
+        std::vector<NamedValue> expected = records;
+
+        std::sort(expected.begin(), expected.end());
+        SortKeys::radix_sort<4>(records.begin(), records.end());
+
+        CHECK(records == expected);
+    }
+
+    SECTION("same order as std::sort")
+    {
+        std::vector<NamedValue> records;
+        for (const auto& x : create_random_records(100'000, "key-"))
+            records.push_back({x.s, x.a});
+        std::vector<NamedValue> expected = records;
+
+        std::sort(expected.begin(), expected.end());
+        SortKeys::radix_sort<6>(records.begin(), records.end());
+
+        CHECK(records == expected);
+    }
+}
+
+TEST_CASE("sort keys - benchmark", "[.benchmark]")
+{
+    const std::vector<X> records = create_random_records(1'000'000);
+
+    BENCHMARK("std::sort - tied() comparator")
+    {
+        std::vector<X> data = records;
+        std::sort(data.begin(), data.end());
+        return data.size();
+    };
+
+    BENCHMARK("SortKeys::radix_sort")
+    {
+        std::vector<X> data = records;
+        SortKeys::radix_sort(data.begin(), data.end());
+        return data.size();
+    };
+}
+
 auto calc_stats(const std::vector<int>& data)
 {
     auto [min_pos, max_pos] = std::minmax_element(data.begin(), data.end());
@@ -288,4 +569,311 @@ TEST_CASE("tuples")
         CHECK(min == 1);
         CHECK(max == 665);
     }
-}
\ No newline at end of file
+}
+
+std::vector<int> create_random_data(size_t size, unsigned int seed = 665)
+{
+    std::mt19937_64 rnd_gen(seed);
+    std::uniform_int_distribution<int> rnd_distr(-1'000'000, 1'000'000);
+
+    std::vector<int> data(size);
+    std::generate(data.begin(), data.end(), [&] { return rnd_distr(rnd_gen); });
+
+    return data;
+}
+
+TEST_CASE("statistics - accumulator")
+{
+    using Catch::Approx;
+
+    std::vector<int> vec = {1, 2, 3, 665, 5};
+
+    SECTION("single pass")
+    {
+        auto stats = Statistics::calc_stats<int>(vec);
+
+        auto [min, max, avg] = calc_stats(vec);
+        CHECK(stats.count() == 5);
+        CHECK(stats.min() == min);
+        CHECK(stats.max() == max);
+        CHECK(stats.mean() == Approx(avg));
+        CHECK(stats.variance() == Approx(70'173.76));
+    }
+
+    SECTION("streaming push")
+    {
+        Statistics::Accumulator<int> stats;
+        for (int x : vec)
+            stats.push(x);
+
+        CHECK(stats.count() == 5);
+        CHECK(stats.min() == 1);
+        CHECK(stats.max() == 665);
+        CHECK(stats.mean() == Approx(135.2));
+        CHECK(stats.sample_variance() == Approx(87'717.2));
+    }
+
+    SECTION("merge of partial results")
+    {
+        Statistics::Accumulator<int> first_half, second_half;
+        first_half.push(std::span{vec}.first(2));
+        second_half.push(std::span{vec}.subspan(2));
+
+        first_half.merge(second_half);
+
+        CHECK(first_half.count() == 5);
+        CHECK(first_half.min() == 1);
+        CHECK(first_half.max() == 665);
+        CHECK(first_half.variance() == Approx(70'173.76));
+    }
+
+    SECTION("parallel = sequential")
+    {
+        std::vector<int> data = create_random_data(1'000'003);
+
+        auto seq = Statistics::calc_stats<int>(data);
+        auto par = Statistics::parallel_calc_stats<int>(data, 4);
+
+        auto [min, max, avg] = calc_stats(data);
+        CHECK(seq.min() == min);
+        CHECK(seq.max() == max);
+        CHECK(seq.mean() == Approx(avg));
+
+        CHECK(par.count() == seq.count());
+        CHECK(par.min() == seq.min());
+        CHECK(par.max() == seq.max());
+        CHECK(par.mean() == Approx(seq.mean()));
+        CHECK(par.variance() == Approx(seq.variance()));
+    }
+
+    SECTION("large offset - no catastrophic cancellation")
+    {
+        Statistics::Accumulator<double> stats;
+        std::vector<double> data = {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16};
+        stats.push(std::span<const double>{data});
+
+        CHECK(stats.variance() == Approx(22.5));
+
+        // many blocks - lanes & blocks are merged
+        std::vector<double> large_data(100'004);
+        for (std::size_t i = 0; i < large_data.size(); ++i)
+            large_data[i] = data[i % data.size()];
+
+        Statistics::Accumulator<double> large_stats;
+        large_stats.push(std::span<const double>{large_data});
+
+        CHECK(large_stats.mean() == Approx(1e9 + 10).epsilon(1e-15));
+        CHECK(large_stats.variance() == Approx(22.5).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("statistics - benchmark", "[.benchmark]")
+{
+    const std::vector<int> data = create_random_data(100'000'000);
+
+    {
+        // best of 5 runs - the single pass should be at least 3x faster
+        auto best_time = [](auto f) {
+            auto best = std::chrono::steady_clock::duration::max();
+            for (int i = 0; i < 5; ++i)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                auto result = f();
+                Catch::Benchmark::keep_memory(&result);
+                best = std::min(best, std::chrono::steady_clock::now() - start);
+            }
+            return std::chrono::duration<double, std::milli>(best).count();
+        };
+
+        const double baseline_ms = best_time([&] { return calc_stats(data); });
+        const double single_pass_ms = best_time([&] { return Statistics::calc_stats<int>(data); });
+
+        std::cout << "calc_stats: " << baseline_ms << " ms, Statistics::calc_stats: " << single_pass_ms
+                  << " ms - speedup " << baseline_ms / single_pass_ms << "x\n";
+    }
+
+    BENCHMARK("calc_stats - minmax_element + accumulate")
+    {
+        return calc_stats(data);
+    };
+
+    BENCHMARK("Statistics::calc_stats - single pass")
+    {
+        return Statistics::calc_stats<int>(data);
+    };
+
+    BENCHMARK("Statistics::parallel_calc_stats")
+    {
+        return Statistics::parallel_calc_stats<int>(data);
+    };
+}
+
+// fraction of items <= value in sorted data
+double rank_of(const std::vector<double>& sorted_data, double value)
+{
+    auto pos = std::upper_bound(sorted_data.begin(), sorted_data.end(), value);
+    return static_cast<double>(pos - sorted_data.begin()) / sorted_data.size();
+}
+
+TEST_CASE("quantiles - t-digest")
+{
+    std::mt19937_64 rnd_gen(665);
+    std::lognormal_distribution<double> rnd_distr(0.0, 1.0);
+
+    std::vector<double> data(1'000'000);
+    std::generate(data.begin(), data.end(), [&] { return rnd_distr(rnd_gen); });
+
+    std::vector<double> sorted_data = data;
+    std::sort(sorted_data.begin(), sorted_data.end());
+
+    SECTION("streaming insertion - rank error")
+    {
+        Quantiles::TDigest digest;
+        for (double x : data)
+            digest.push(x);
+
+        CHECK(digest.count() == data.size());
+        CHECK(digest.min() == sorted_data.front());
+        CHECK(digest.max() == sorted_data.back());
+        CHECK(digest.centroid_count() <= 100);
+
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.5)) - 0.5) < 0.002);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.99)) - 0.99) < 0.001);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.999)) - 0.999) < 0.0005);
+    }
+
+    SECTION("higher compression - smaller rank error")
+    {
+        Quantiles::TDigest digest{500};
+        digest.push(data);
+
+        CHECK(digest.centroid_count() <= 500);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.99)) - 0.99) < 0.0002);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.999)) - 0.999) < 0.0001);
+    }
+
+    SECTION("merging across threads & serialization")
+    {
+        const size_t thread_count = 4;
+        const size_t chunk_size = data.size() / thread_count;
+
+        std::vector<std::vector<std::byte>> partial_digests(thread_count);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t] {
+                Quantiles::TDigest digest;
+                digest.push(std::span{data}.subspan(t * chunk_size, chunk_size));
+                partial_digests[t] = digest.serialize();
+            });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        Quantiles::TDigest digest;
+        for (const auto& bytes : partial_digests)
+            digest.merge(Quantiles::TDigest::deserialize(bytes));
+
+        CHECK(digest.count() == data.size());
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.5)) - 0.5) < 0.002);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.99)) - 0.99) < 0.001);
+        CHECK(std::abs(rank_of(sorted_data, digest.quantile(0.999)) - 0.999) < 0.0005);
+    }
+
+    SECTION("const queries & merging from a shared digest don't modify it")
+    {
+        Quantiles::TDigest shared;
+        shared.push(std::span{data}.first(1'500)); // part of the values stays buffered
+        const std::vector<std::byte> bytes_before = shared.serialize();
+
+        std::vector<double> medians(4);
+        std::vector<double> merged_counts(medians.size());
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < medians.size(); ++t)
+        {
+            threads.emplace_back([&, t] {
+                Quantiles::TDigest local;
+                local.merge(shared);
+                medians[t] = shared.quantile(0.5);
+                merged_counts[t] = local.count();
+            });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        // Catch2 assertions aren't thread-safe - results are checked after join
+        CHECK(std::all_of(merged_counts.begin(), merged_counts.end(), [&](double count) { return count == shared.count(); }));
+        CHECK(shared.serialize() == bytes_before);
+        CHECK(std::all_of(medians.begin(), medians.end(), [&](double m) { return m == medians[0]; }));
+
+        Quantiles::TDigest flushed = shared;
+        flushed.flush();
+        CHECK(flushed.quantile(0.5) == medians[0]);
+        CHECK(flushed.serialize() == bytes_before);
+    }
+
+    SECTION("invalid serialized data")
+    {
+        Quantiles::TDigest digest;
+        digest.push(std::span{data}.first(1000));
+
+        auto bytes = digest.serialize();
+        bytes.pop_back();
+
+        CHECK_THROWS_AS(Quantiles::TDigest::deserialize(bytes), std::invalid_argument);
+
+        for (double compression : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), 1e300})
+        {
+            auto corrupted = digest.serialize();
+            std::memcpy(corrupted.data(), &compression, sizeof(compression)); // compression is the first field
+            CHECK_THROWS_AS(Quantiles::TDigest::deserialize(corrupted), std::invalid_argument);
+        }
+    }
+}
+
+TEST_CASE("quantiles - benchmark", "[.benchmark]")
+{
+    const std::vector<int> data = create_random_data(100'000'000);
+
+    // accuracy against exact nth_element - error of the estimate's rank
+    {
+        Quantiles::TDigest digest;
+        digest.push(std::span{data});
+        digest.flush();
+
+        std::vector<int> copy = data;
+        for (double q : {0.5, 0.99, 0.999})
+        {
+            auto nth = copy.begin() + static_cast<ptrdiff_t>(q * (copy.size() - 1));
+            std::nth_element(copy.begin(), nth, copy.end());
+
+            const double estimate = digest.quantile(q);
+            const auto below = std::count_if(data.begin(), data.end(), [estimate](int x) { return x <= estimate; });
+            std::cout << "q=" << q << " - exact: " << *nth << ", t-digest: " << estimate
+                      << ", rank error: " << std::abs(static_cast<double>(below) / data.size() - q) << "\n";
+        }
+    }
+
+    BENCHMARK("nth_element on a copy - median, p99, p999")
+    {
+        std::vector<int> copy = data;
+        std::array<int, 3> result;
+        for (size_t i = 0; double q : {0.5, 0.99, 0.999})
+        {
+            auto nth = copy.begin() + static_cast<ptrdiff_t>(q * (copy.size() - 1));
+            std::nth_element(copy.begin(), nth, copy.end());
+            result[i++] = *nth;
+        }
+        return result;
+    };
+
+    BENCHMARK("TDigest - median, p99, p999")
+    {
+        Quantiles::TDigest digest;
+        digest.push(std::span{data});
+        digest.flush();
+        return std::array{digest.quantile(0.5), digest.quantile(0.99), digest.quantile(0.999)};
+    };
+}
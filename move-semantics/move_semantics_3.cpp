@@ -1,5 +1,6 @@
 #include "helpers.hpp"
 
+#include <alloc_tracker.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
 
@@ -95,4 +96,16 @@ TEST_CASE("Data & move semantics")
 
     Data backup = ds1; // copy
     print("backup", backup);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Data - allocation budget")
+{
+    Data ds1{"ds1", {1, 2, 3, 4, 5}};
+
+    AllocTracker::Scope alloc_scope;
+
+    Data backup = ds1; // copy - one buffer for items (short name fits in SSO)
+
+    CHECK(alloc_scope.allocations() == 1);
+    CHECK(alloc_scope.bytes_allocated() == 5 * sizeof(int));
+}
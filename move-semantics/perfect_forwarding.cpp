@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <deque>
+#include <lifecycle.hpp>
 
 #ifdef _MSC_VER
 #define __PRETTY_FUNCTION__ __FUNCSIG__
@@ -117,4 +118,45 @@ TEST_CASE("using forwarding")
     data.add(g);
 
     data.add(Gadget{665});
-}
\ No newline at end of file
+}
+
+TEST_CASE("using forwarding - copy/move budget")
+{
+    Data data;
+    data.gadgets.reserve(2);
+
+    SECTION("lvalue is copied once")
+    {
+        Gadget g{42};
+
+        Lifecycle::Scope<Gadget> lifecycle_scope;
+        data.add(g);
+
+        CHECK(lifecycle_scope.copies() == 1);
+        CHECK(lifecycle_scope.moves() == 0);
+    }
+
+    SECTION("rvalue is moved - never copied")
+    {
+        Lifecycle::Scope<Gadget> lifecycle_scope;
+        data.add(Gadget{665});
+
+        auto stats = lifecycle_scope.stats();
+        CHECK(stats.constructed == 1);
+        CHECK(stats.copies() == 0);
+        CHECK(stats.move_constructed == 1);
+        CHECK(stats.destroyed == 1); // moved-from temporary
+    }
+
+    SECTION("vector growth moves gadgets")
+    {
+        data.add(Gadget{1});
+        data.add(Gadget{2});
+
+        Lifecycle::Scope<Gadget> lifecycle_scope;
+        data.add(Gadget{3}); // reallocation
+
+        CHECK(lifecycle_scope.copies() == 0);
+        CHECK(lifecycle_scope.stats().move_constructed == 3);
+    }
+}
@@ -0,0 +1,309 @@
+#ifndef QUANTILES_HPP
+#define QUANTILES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Quantiles - t-digest (merging variant) for approximate quantiles
+//
+// Memory is bounded by the compression (number of centroids ~ compression).
+// Centroids near the tails are kept small (k1 scale function), so p99 & p999
+// are much more accurate than the median. Digests can be merged & serialized.
+//
+// Pushed values are buffered & merged into centroids when the buffer is full or by flush().
+// Const member functions don't modify the digest (safe to call concurrently) - with values
+// buffered, queries work on a compressed copy, so flush() before querying many times.
+
+namespace Quantiles
+{
+    class TDigest
+    {
+    public:
+        struct Centroid
+        {
+            double mean;
+            double weight;
+        };
+
+        static constexpr double max_compression = 1e6;
+
+        explicit TDigest(double compression = 100.0)
+            : compression_{compression}
+        {
+            if (!(compression >= 10.0 && compression <= max_compression)) // also rejects NaN
+                throw std::invalid_argument("Compression must be in [10, 1e6]");
+
+            buffer_.reserve(buffer_capacity());
+        }
+
+        void push(double value)
+        {
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+
+            buffer_.push_back(Centroid{value, 1.0});
+            if (buffer_.size() >= buffer_capacity())
+                flush();
+        }
+
+        template <std::ranges::input_range Range>
+        void push(const Range& values)
+        {
+            for (const auto& value : values)
+                push(static_cast<double>(value));
+        }
+
+        // other is only read - its buffered values are merged too
+        void merge(const TDigest& other)
+        {
+            if (this == &other)
+            {
+                TDigest copy = other;
+                merge(copy);
+                return;
+            }
+
+            for (const std::vector<Centroid>* centroids : {&other.centroids_, &other.buffer_})
+            {
+                for (const Centroid& c : *centroids)
+                {
+                    buffer_.push_back(c);
+                    if (buffer_.size() >= buffer_capacity())
+                        flush();
+                }
+            }
+
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        // merges buffered values into centroids
+        void flush()
+        {
+            if (buffer_.empty())
+                return;
+
+            centroids_ = compressed();
+            total_weight_ = count();
+            buffer_.clear();
+        }
+
+        double count() const
+        {
+            double total = total_weight_;
+            for (const Centroid& c : buffer_)
+                total += c.weight;
+            return total;
+        }
+
+        double min() const
+        {
+            return min_;
+        }
+
+        double max() const
+        {
+            return max_;
+        }
+
+        double compression() const
+        {
+            return compression_;
+        }
+
+        std::size_t centroid_count() const
+        {
+            return buffer_.empty() ? centroids_.size() : compressed().size();
+        }
+
+        double quantile(double q) const
+        {
+            if (buffer_.empty())
+                return quantile(centroids_, q);
+
+            return quantile(compressed(), q);
+        }
+
+        // layout: compression, min, max, centroid count, centroids (mean, weight) - native byte order
+        std::vector<std::byte> serialize() const
+        {
+            const std::vector<Centroid> flushed = buffer_.empty() ? std::vector<Centroid>{} : compressed();
+            const std::vector<Centroid>& centroids = buffer_.empty() ? centroids_ : flushed;
+
+            const std::uint64_t size = centroids.size();
+
+            std::vector<std::byte> bytes(header_size + size * sizeof(Centroid));
+            std::byte* out = bytes.data();
+            out = write(out, compression_);
+            out = write(out, min_);
+            out = write(out, max_);
+            out = write(out, size);
+            if (size > 0)
+                std::memcpy(out, centroids.data(), size * sizeof(Centroid));
+
+            return bytes;
+        }
+
+        static TDigest deserialize(std::span<const std::byte> bytes)
+        {
+            if (bytes.size() < header_size)
+                throw std::invalid_argument("Serialized t-digest is too short");
+
+            const std::byte* in = bytes.data();
+            double compression, min, max;
+            std::uint64_t size;
+            in = read(in, compression);
+            in = read(in, min);
+            in = read(in, max);
+            in = read(in, size);
+
+            if (size > (bytes.size() - header_size) / sizeof(Centroid) || bytes.size() != header_size + size * sizeof(Centroid))
+                throw std::invalid_argument("Serialized t-digest has invalid size");
+
+            TDigest digest{compression}; // throws for a corrupted (non-finite or absurd) compression
+            digest.min_ = min;
+            digest.max_ = max;
+            digest.centroids_.resize(size);
+            if (size > 0)
+                std::memcpy(digest.centroids_.data(), in, size * sizeof(Centroid));
+            for (const Centroid& c : digest.centroids_)
+                digest.total_weight_ += c.weight;
+
+            return digest;
+        }
+
+    private:
+        static constexpr std::size_t header_size = 3 * sizeof(double) + sizeof(std::uint64_t);
+
+        double compression_;
+        double min_ = std::numeric_limits<double>::infinity();
+        double max_ = -std::numeric_limits<double>::infinity();
+
+        std::vector<Centroid> centroids_;
+        std::vector<Centroid> buffer_;
+        double total_weight_ = 0.0; // weight of centroids_ - without buffered values
+
+        std::size_t buffer_capacity() const
+        {
+            return static_cast<std::size_t>(10 * compression_);
+        }
+
+        // k1 scale function: k(q) = compression / (2 pi) * asin(2q - 1)
+        double k_of_q(double q) const
+        {
+            return compression_ / (2 * std::numbers::pi) * std::asin(2 * q - 1);
+        }
+
+        double q_of_k(double k) const
+        {
+            return (std::sin(std::min(k * 2 * std::numbers::pi / compression_, std::numbers::pi / 2)) + 1) / 2;
+        }
+
+        // centroids with buffered values merged in - the digest isn't modified
+        std::vector<Centroid> compressed() const
+        {
+            auto by_mean = [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; };
+
+            std::vector<Centroid> buffered = buffer_;
+            std::sort(buffered.begin(), buffered.end(), by_mean);
+
+            std::vector<Centroid> sorted;
+            sorted.reserve(centroids_.size() + buffered.size());
+            std::merge(centroids_.begin(), centroids_.end(), buffered.begin(), buffered.end(), std::back_inserter(sorted), by_mean);
+
+            std::vector<Centroid> result;
+            if (sorted.empty())
+                return result;
+
+            const double total = count();
+            result.push_back(sorted.front());
+
+            double weight_so_far = 0.0; // weight of centroids before the last one
+            double q_limit = q_of_k(k_of_q(0.0) + 1);
+
+            for (auto it = std::next(sorted.begin()); it != sorted.end(); ++it)
+            {
+                Centroid& current = result.back();
+                const double proposed_weight = current.weight + it->weight;
+
+                if ((weight_so_far + proposed_weight) / total <= q_limit)
+                {
+                    current.mean += (it->mean - current.mean) * it->weight / proposed_weight;
+                    current.weight = proposed_weight;
+                }
+                else
+                {
+                    weight_so_far += current.weight;
+                    q_limit = q_of_k(k_of_q(weight_so_far / total) + 1);
+                    result.push_back(*it);
+                }
+            }
+
+            return result;
+        }
+
+        double quantile(const std::vector<Centroid>& centroids, double q) const
+        {
+            if (centroids.empty())
+                return std::numeric_limits<double>::quiet_NaN();
+
+            q = std::clamp(q, 0.0, 1.0);
+            if (q == 0.0)
+                return min_;
+            if (q == 1.0)
+                return max_;
+
+            const double total_weight = count();
+            const double target = q * total_weight;
+
+            const Centroid& first = centroids.front();
+            if (target < first.weight / 2)
+                return min_ + (first.mean - min_) * target / (first.weight / 2);
+
+            double cumulative = 0.0;
+            for (std::size_t i = 0; i + 1 < centroids.size(); ++i)
+            {
+                const Centroid& left = centroids[i];
+                const Centroid& right = centroids[i + 1];
+
+                const double left_center = cumulative + left.weight / 2;
+                const double right_center = cumulative + left.weight + right.weight / 2;
+
+                if (target <= right_center)
+                    return left.mean + (right.mean - left.mean) * (target - left_center) / (right_center - left_center);
+
+                cumulative += left.weight;
+            }
+
+            const Centroid& last = centroids.back();
+            const double last_center = total_weight - last.weight / 2;
+            return last.mean + (max_ - last.mean) * std::min(1.0, (target - last_center) / (last.weight / 2));
+        }
+
+        template <typename T>
+        static std::byte* write(std::byte* out, const T& value)
+        {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+
+        template <typename T>
+        static const std::byte* read(const std::byte* in, T& value)
+        {
+            std::memcpy(&value, in, sizeof(T));
+            return in + sizeof(T);
+        }
+    };
+} // namespace Quantiles
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef SORT_KEYS_HPP
+#define SORT_KEYS_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Normalized sort keys - order preserving, memcmp-comparable byte keys
+// derived from a tied() tuple
+//
+// integers & floating points are encoded exactly, strings by a fixed-size
+// prefix padded with zeros - records with equal keys are ordered by tied()
+//
+// a key ends with the first string field: a cut-off (or NUL-padded) prefix can tie
+// different strings, so the fields after it mustn't decide the order
+
+namespace SortKeys
+{
+    template <std::unsigned_integral T>
+    void store_big_endian(std::byte* out, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+            out[i] = static_cast<std::byte>(value >> (8 * (sizeof(T) - 1 - i)));
+    }
+
+    template <typename T>
+    struct Encoder;
+
+    template <std::integral T>
+    struct Encoder<T>
+    {
+        static constexpr std::size_t size = sizeof(T);
+
+        static void encode(std::byte* out, T value)
+        {
+            using U = std::make_unsigned_t<T>;
+
+            U bits = static_cast<U>(value);
+            if constexpr (std::is_signed_v<T>)
+                bits ^= U{1} << (8 * sizeof(T) - 1); // flip sign bit - negatives go first
+
+            store_big_endian(out, bits);
+        }
+    };
+
+    template <std::floating_point T>
+        requires(sizeof(T) == 4 || sizeof(T) == 8)
+    struct Encoder<T>
+    {
+        static constexpr std::size_t size = sizeof(T);
+
+        static void encode(std::byte* out, T value)
+        {
+            using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            constexpr U sign_bit = U{1} << (8 * sizeof(T) - 1);
+
+            if (value == T{})
+                value = T{}; // -0.0 == 0.0 for tied() - must get the same key
+
+            U bits = std::bit_cast<U>(value);
+            bits = (bits & sign_bit) ? ~bits : (bits | sign_bit);
+
+            store_big_endian(out, bits);
+        }
+    };
+
+    template <std::size_t PrefixLength>
+    struct StringEncoder
+    {
+        static constexpr std::size_t size = PrefixLength;
+
+        static void encode(std::byte* out, std::string_view str)
+        {
+            const std::size_t length = std::min(str.size(), PrefixLength);
+            std::memcpy(out, str.data(), length);
+            std::memset(out + length, 0, PrefixLength - length);
+        }
+    };
+
+    template <typename T, std::size_t StringPrefix>
+    struct EncoderFor
+    {
+        using type = Encoder<T>;
+    };
+
+    template <std::size_t StringPrefix>
+    struct EncoderFor<std::string, StringPrefix>
+    {
+        using type = StringEncoder<StringPrefix>;
+    };
+
+    template <std::size_t StringPrefix>
+    struct EncoderFor<std::string_view, StringPrefix>
+    {
+        using type = StringEncoder<StringPrefix>;
+    };
+
+    template <typename T, std::size_t StringPrefix>
+    using EncoderFor_t = typename EncoderFor<std::remove_cvref_t<T>, StringPrefix>::type;
+
+    template <typename T>
+    constexpr bool is_string_like_v = std::is_same_v<std::remove_cvref_t<T>, std::string>
+        || std::is_same_v<std::remove_cvref_t<T>, std::string_view>;
+
+    template <typename Tuple, std::size_t StringPrefix>
+    struct KeyTraits;
+
+    template <typename... Ts, std::size_t StringPrefix>
+    struct KeyTraits<std::tuple<Ts...>, StringPrefix>
+    {
+        static constexpr std::size_t first_string = []
+        {
+            constexpr bool is_string[] = {is_string_like_v<Ts>..., false};
+            std::size_t index = 0;
+            while (index < sizeof...(Ts) && !is_string[index])
+                ++index;
+            return index;
+        }();
+
+        // fields encoded in the key - up to & including the first string
+        static constexpr std::size_t field_count = std::min(first_string + 1, sizeof...(Ts));
+
+        static constexpr std::size_t size = []
+        {
+            constexpr std::size_t sizes[] = {EncoderFor_t<Ts, StringPrefix>::size...};
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < field_count; ++i)
+                total += sizes[i];
+            return total;
+        }();
+
+        // only truncated strings can make keys of different records equal
+        static constexpr bool may_tie = first_string < sizeof...(Ts);
+    };
+
+    template <std::size_t StringPrefix, typename Tuple>
+    void encode_key(std::byte* out, const Tuple& tpl)
+    {
+        constexpr std::size_t field_count = KeyTraits<std::remove_cvref_t<Tuple>, StringPrefix>::field_count;
+
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((EncoderFor_t<std::tuple_element_t<Is, Tuple>, StringPrefix>::encode(out, std::get<Is>(tpl)),
+                 out += EncoderFor_t<std::tuple_element_t<Is, Tuple>, StringPrefix>::size),
+                ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    template <std::size_t KeySize>
+    struct Entry
+    {
+        std::array<std::byte, KeySize> key;
+        std::uint32_t index;
+    };
+
+    namespace Detail
+    {
+        constexpr std::size_t small_bucket = 64;
+
+        // sorts n entries from data - result is placed in target (data or scratch)
+        template <std::size_t KeySize>
+        void msd_radix_sort(Entry<KeySize>* data, Entry<KeySize>* scratch, Entry<KeySize>* target, std::size_t n, std::size_t depth)
+        {
+            while (depth < KeySize && n >= small_bucket)
+            {
+                std::array<std::size_t, 256> counts{};
+                for (std::size_t i = 0; i < n; ++i)
+                    ++counts[std::to_integer<std::uint8_t>(data[i].key[depth])];
+
+                // common prefix - nothing to distribute on this byte
+                if (counts[std::to_integer<std::uint8_t>(data[0].key[depth])] == n)
+                {
+                    ++depth;
+                    continue;
+                }
+
+                std::array<std::size_t, 256> offsets;
+                std::size_t offset = 0;
+                for (std::size_t b = 0; b < 256; ++b)
+                {
+                    offsets[b] = offset;
+                    offset += counts[b];
+                }
+
+                for (std::size_t i = 0; i < n; ++i)
+                    scratch[offsets[std::to_integer<std::uint8_t>(data[i].key[depth])]++] = data[i];
+
+                // buckets are in scratch now - roles of buffers are swapped for the next byte
+                const bool target_is_data = (target == data);
+                std::size_t start = 0;
+                for (std::size_t b = 0; b < 256; ++b)
+                {
+                    if (counts[b] != 0)
+                    {
+                        Entry<KeySize>* bucket_target = target_is_data ? data + start : scratch + start;
+                        msd_radix_sort(scratch + start, data + start, bucket_target, counts[b], depth + 1);
+                    }
+                    start += counts[b];
+                }
+
+                return;
+            }
+
+            if (depth < KeySize && n > 1)
+            {
+                std::sort(data, data + n, [depth](const auto& a, const auto& b) {
+                    return std::memcmp(a.key.data() + depth, b.key.data() + depth, KeySize - depth) < 0;
+                });
+            }
+
+            if (target != data)
+                std::copy(data, data + n, target);
+        }
+    } // namespace Detail
+
+    // sorts records by keys built from tied() - equivalent to std::sort with tied() < other.tied()
+    template <std::size_t StringPrefix = 16, typename RandomIt>
+    void radix_sort(RandomIt first, RandomIt last)
+    {
+        using Record = typename std::iterator_traits<RandomIt>::value_type;
+        using Traits = KeyTraits<std::remove_cvref_t<decltype(std::declval<const Record&>().tied())>, StringPrefix>;
+
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        if (n < 2)
+            return;
+
+        std::vector<Entry<Traits::size>> entries(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            encode_key<StringPrefix>(entries[i].key.data(), first[i].tied());
+            entries[i].index = static_cast<std::uint32_t>(i);
+        }
+
+        {
+            std::vector<Entry<Traits::size>> buffer(n);
+            Detail::msd_radix_sort(entries.data(), buffer.data(), entries.data(), n, 0);
+        }
+
+        if constexpr (Traits::may_tie)
+        {
+            auto by_tied = [first](const auto& a, const auto& b) {
+                return first[a.index].tied() < first[b.index].tied();
+            };
+
+            for (auto run = entries.begin(); run != entries.end();)
+            {
+                auto run_end = std::find_if(std::next(run), entries.end(), [&run](const auto& e) { return e.key != run->key; });
+                if (std::distance(run, run_end) > 1)
+                    std::sort(run, run_end, by_tied);
+                run = run_end;
+            }
+        }
+
+        std::vector<Record> sorted;
+        sorted.reserve(n);
+        for (const auto& e : entries)
+            sorted.push_back(std::move(first[e.index]));
+
+        std::move(sorted.begin(), sorted.end(), first);
+    }
+} // namespace SortKeys
+
+#endif
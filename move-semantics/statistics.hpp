@@ -0,0 +1,211 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Statistics - mergeable accumulator of count, min, max, mean & variance
+//
+// push(value) - streaming update (Welford)
+// push(span)  - single pass over blocks - Welford updates in independent lanes (vectorizable),
+//               lanes & blocks are merged with Chan's formula
+// merge()     - combines partial results, e.g. computed by other threads
+
+namespace Statistics
+{
+    template <typename T>
+    class Accumulator
+    {
+        std::size_t count_ = 0;
+        T min_ = std::numeric_limits<T>::max();
+        T max_ = std::numeric_limits<T>::lowest();
+        double mean_ = 0.0;
+        double m2_ = 0.0; // sum of squared deviations from the mean
+
+        static constexpr std::size_t block_size = 4096;
+        static constexpr std::size_t lanes = 16;
+
+    public:
+        Accumulator() = default;
+
+        Accumulator(std::size_t count, T min, T max, double mean, double m2)
+            : count_{count}
+            , min_{min}
+            , max_{max}
+            , mean_{mean}
+            , m2_{m2}
+        {
+        }
+
+        void push(T value)
+        {
+            ++count_;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+
+            const double delta = static_cast<double>(value) - mean_;
+            mean_ += delta / static_cast<double>(count_);
+            m2_ += delta * (static_cast<double>(value) - mean_);
+        }
+
+        void push(std::span<const T> values)
+        {
+            while (!values.empty())
+            {
+                const std::size_t n = std::min(values.size(), block_size);
+                merge(accumulate_block(values.first(n)));
+                values = values.subspan(n);
+            }
+        }
+
+        void merge(const Accumulator& other)
+        {
+            if (other.count_ == 0)
+                return;
+
+            if (count_ == 0)
+            {
+                *this = other;
+                return;
+            }
+
+            const double n_a = static_cast<double>(count_);
+            const double n_b = static_cast<double>(other.count_);
+            const double n = n_a + n_b;
+            const double delta = other.mean_ - mean_;
+
+            count_ += other.count_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+            mean_ += delta * n_b / n;
+            m2_ += other.m2_ + delta * delta * n_a * n_b / n;
+        }
+
+        std::size_t count() const
+        {
+            return count_;
+        }
+
+        T min() const
+        {
+            return min_;
+        }
+
+        T max() const
+        {
+            return max_;
+        }
+
+        double mean() const
+        {
+            return mean_;
+        }
+
+        double variance() const // population variance
+        {
+            return count_ > 0 ? m2_ / static_cast<double>(count_) : 0.0;
+        }
+
+        double sample_variance() const
+        {
+            return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+        }
+
+        double stddev() const
+        {
+            return std::sqrt(variance());
+        }
+
+    private:
+        // Welford updates in independent lanes (vectorizable) - the lanes share the count, so there is
+        // one division per lanes values; lanes & the tail are merged with Chan's formula
+        static Accumulator accumulate_block(std::span<const T> block)
+        {
+            std::array<double, lanes> mean{};
+            std::array<double, lanes> m2{};
+            std::array<T, lanes> min;
+            std::array<T, lanes> max;
+            min.fill(block[0]);
+            max.fill(block[0]);
+
+            const std::size_t steps = block.size() / lanes;
+            for (std::size_t step = 0; step < steps; ++step)
+            {
+                const double inv_count = 1.0 / static_cast<double>(step + 1);
+                const T* values = block.data() + step * lanes;
+
+                for (std::size_t l = 0; l < lanes; ++l)
+                {
+                    const T value = values[l];
+                    const double delta = static_cast<double>(value) - mean[l];
+                    mean[l] += delta * inv_count;
+                    m2[l] += delta * (static_cast<double>(value) - mean[l]);
+                    min[l] = value < min[l] ? value : min[l];
+                    max[l] = value > max[l] ? value : max[l];
+                }
+            }
+
+            Accumulator result;
+            if (steps > 0)
+            {
+                for (std::size_t l = 0; l < lanes; ++l)
+                    result.merge(Accumulator{steps, min[l], max[l], mean[l], m2[l]});
+            }
+
+            for (std::size_t i = steps * lanes; i < block.size(); ++i)
+                result.push(block[i]);
+
+            return result;
+        }
+    };
+
+    template <typename T>
+    Accumulator<T> calc_stats(std::span<const T> data)
+    {
+        Accumulator<T> stats;
+        stats.push(data);
+        return stats;
+    }
+
+    // each thread accumulates a contiguous chunk - partial results are merged
+    template <typename T>
+    Accumulator<T> parallel_calc_stats(std::span<const T> data, std::size_t thread_count = std::thread::hardware_concurrency())
+    {
+        thread_count = std::clamp<std::size_t>(thread_count, 1, std::max<std::size_t>(1, data.size() / 4096));
+
+        std::vector<Accumulator<T>> partial_stats(thread_count);
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+
+        const std::size_t chunk_size = data.size() / thread_count;
+        for (std::size_t t = 0; t < thread_count; ++t)
+        {
+            const std::size_t offset = t * chunk_size;
+            const std::size_t count = (t == thread_count - 1) ? data.size() - offset : chunk_size;
+            auto chunk = data.subspan(offset, count);
+
+            if (t == thread_count - 1)
+                partial_stats[t].push(chunk); // last chunk on the calling thread
+            else
+                threads.emplace_back([&stats = partial_stats[t], chunk] { stats.push(chunk); });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        Accumulator<T> stats;
+        for (const auto& partial : partial_stats)
+            stats.merge(partial);
+
+        return stats;
+    }
+} // namespace Statistics
+
+#endif
@@ -0,0 +1,139 @@
+#include "utils.hpp"
+
+#include <arena.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using Utils::Gadget;
+
+namespace
+{
+    struct Tracked
+    {
+        std::vector<int>& destroyed;
+        int id;
+
+        ~Tracked()
+        {
+            destroyed.push_back(id);
+        }
+    };
+} // namespace
+
+TEST_CASE("arena")
+{
+    SECTION("objects die together - in reverse order of creation")
+    {
+        std::vector<int> destroyed;
+
+        {
+            Memory::Arena arena;
+
+            for (int i = 0; i < 3; ++i)
+                arena.create<Tracked>(destroyed, i);
+
+            Gadget* g = arena.create<Gadget>(42, "ipad");
+            CHECK(g->id() == 42);
+            CHECK(destroyed.empty());
+        }
+
+        CHECK(destroyed == std::vector{2, 1, 0});
+    }
+
+    SECTION("bump allocation respects alignment")
+    {
+        Memory::Arena arena{256};
+
+        arena.create<char>('a');
+        auto* value = arena.create<double>(3.14);
+        CHECK(reinterpret_cast<std::uintptr_t>(value) % alignof(double) == 0);
+
+        struct alignas(64) CacheLine
+        {
+            char data[64];
+        };
+        auto* line = arena.create<CacheLine>();
+        CHECK(reinterpret_cast<std::uintptr_t>(line) % 64 == 0);
+    }
+
+    SECTION("grows by chunks")
+    {
+        Memory::Arena arena{1024};
+
+        for (int i = 0; i < 10'000; ++i)
+            arena.create<int>(i);
+        CHECK(arena.allocate(100'000) != nullptr); // larger than a chunk
+
+        CHECK(arena.bytes_reserved() >= 10'000 * sizeof(int) + 100'000);
+
+        arena.release();
+        CHECK(arena.bytes_reserved() == 0);
+    }
+
+    SECTION("memory resource for pmr containers")
+    {
+        Memory::Arena arena;
+
+        std::pmr::vector<std::pmr::string> words{&arena};
+        words.emplace_back("a string longer than small string buffer");
+        words.emplace_back("ipad");
+
+        CHECK(words.get_allocator().resource() == &arena);
+        CHECK(words[0].get_allocator().resource() == &arena);
+        CHECK(arena.bytes_reserved() > 0);
+    }
+}
+
+namespace
+{
+    struct Point
+    {
+        int id;
+        double x, y;
+    };
+} // namespace
+
+TEST_CASE("arena - benchmark", "[.benchmark]")
+{
+    const int count = 1'000'000;
+
+    BENCHMARK("new/delete")
+    {
+        std::vector<Point*> points;
+        points.reserve(count);
+        for (int i = 0; i < count; ++i)
+            points.push_back(new Point{i, 1.0, 2.0});
+
+        for (Point* p : points)
+            delete p;
+
+        return points.size();
+    };
+
+    BENCHMARK("unique_ptr")
+    {
+        std::vector<std::unique_ptr<Point>> points;
+        points.reserve(count);
+        for (int i = 0; i < count; ++i)
+            points.push_back(std::make_unique<Point>(i, 1.0, 2.0));
+
+        return points.size();
+    };
+
+    BENCHMARK("Memory::Arena")
+    {
+        Memory::Arena arena;
+
+        std::vector<Point*> points;
+        points.reserve(count);
+        for (int i = 0; i < count; ++i)
+            points.push_back(arena.create<Point>(i, 1.0, 2.0));
+
+        return points.size();
+    };
+}
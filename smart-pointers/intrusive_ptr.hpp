@@ -0,0 +1,253 @@
+#ifndef INTRUSIVE_PTR_HPP
+#define INTRUSIVE_PTR_HPP
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// IntrusivePtr - reference counted pointer with a counter embedded in the object
+//
+// class Gadget : public Intrusive::RefCounted<Gadget> { ... };
+//
+// - handle is a single pointer, no separate control block
+// - a pointer can be recreated from this at any time
+
+namespace Intrusive
+{
+    ///////////////////////////////////////////////////////////
+    // counter policies
+
+    class AtomicCounter
+    {
+        std::atomic<long> count_{0};
+
+    public:
+        void increment() noexcept
+        {
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // returns true when the last reference is released
+        bool decrement() noexcept
+        {
+            return count_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        long value() const noexcept
+        {
+            return count_.load(std::memory_order_relaxed);
+        }
+    };
+
+    class NonAtomicCounter
+    {
+        long count_{0};
+
+    public:
+        void increment() noexcept
+        {
+            ++count_;
+        }
+
+        bool decrement() noexcept
+        {
+            return --count_ == 0;
+        }
+
+        long value() const noexcept
+        {
+            return count_;
+        }
+    };
+
+    template <typename T>
+    class IntrusivePtr;
+
+    ///////////////////////////////////////////////////////////
+    // CRTP base - embeds the counter
+
+    template <typename T, typename CounterPolicy = AtomicCounter>
+    class RefCounted
+    {
+        mutable CounterPolicy ref_count_;
+
+        template <typename U>
+        friend class IntrusivePtr;
+
+        void add_ref() const noexcept
+        {
+            ref_count_.increment();
+        }
+
+        void release() const noexcept
+        {
+            if (ref_count_.decrement())
+                delete static_cast<const T*>(this);
+        }
+
+    protected:
+        RefCounted() = default;
+
+        // copy of an object is a new object - counter is not copied
+        RefCounted(const RefCounted&) noexcept
+        {
+        }
+
+        RefCounted& operator=(const RefCounted&) noexcept
+        {
+            return *this;
+        }
+
+        ~RefCounted() = default;
+
+    public:
+        long use_count() const noexcept
+        {
+            return ref_count_.value();
+        }
+
+        IntrusivePtr<T> intrusive_from_this() noexcept
+        {
+            return IntrusivePtr<T>(static_cast<T*>(this));
+        }
+
+        IntrusivePtr<const T> intrusive_from_this() const noexcept
+        {
+            return IntrusivePtr<const T>(static_cast<const T*>(this));
+        }
+    };
+
+    ///////////////////////////////////////////////////////////
+    // handle
+
+    template <typename T>
+    class IntrusivePtr
+    {
+        T* ptr_;
+
+        template <typename U>
+        friend class IntrusivePtr;
+
+    public:
+        IntrusivePtr() noexcept
+            : ptr_{nullptr}
+        {
+        }
+
+        IntrusivePtr(std::nullptr_t) noexcept
+            : ptr_{nullptr}
+        {
+        }
+
+        // takes a reference - valid also for objects already owned by other IntrusivePtrs
+        explicit IntrusivePtr(T* ptr) noexcept
+            : ptr_{ptr}
+        {
+            if (ptr_)
+                ptr_->add_ref();
+        }
+
+        IntrusivePtr(const IntrusivePtr& other) noexcept
+            : IntrusivePtr(other.ptr_)
+        {
+        }
+
+        // implicit upcasts only - like std::shared_ptr
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        IntrusivePtr(const IntrusivePtr<U>& other) noexcept
+            : IntrusivePtr(other.get())
+        {
+        }
+
+        IntrusivePtr(IntrusivePtr&& other) noexcept
+            : ptr_{std::exchange(other.ptr_, nullptr)}
+        {
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        IntrusivePtr(IntrusivePtr<U>&& other) noexcept
+            : ptr_{std::exchange(other.ptr_, nullptr)}
+        {
+        }
+
+        IntrusivePtr& operator=(const IntrusivePtr& other) noexcept
+        {
+            IntrusivePtr temp(other);
+            swap(temp);
+
+            return *this;
+        }
+
+        IntrusivePtr& operator=(IntrusivePtr&& other) noexcept
+        {
+            IntrusivePtr temp(std::move(other));
+            swap(temp);
+
+            return *this;
+        }
+
+        ~IntrusivePtr()
+        {
+            if (ptr_)
+                ptr_->release();
+        }
+
+        void swap(IntrusivePtr& other) noexcept
+        {
+            std::swap(ptr_, other.ptr_);
+        }
+
+        void reset() noexcept
+        {
+            IntrusivePtr().swap(*this);
+        }
+
+        T* get() const noexcept
+        {
+            return ptr_;
+        }
+
+        T& operator*() const noexcept
+        {
+            return *ptr_;
+        }
+
+        T* operator->() const noexcept
+        {
+            return ptr_;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return ptr_ != nullptr;
+        }
+
+        long use_count() const noexcept
+        {
+            return ptr_ ? ptr_->use_count() : 0;
+        }
+
+        template <typename U>
+        bool operator==(const IntrusivePtr<U>& other) const noexcept
+        {
+            return ptr_ == other.get();
+        }
+
+        bool operator==(std::nullptr_t) const noexcept
+        {
+            return ptr_ == nullptr;
+        }
+    };
+
+    template <typename T, typename... TArgs>
+    IntrusivePtr<T> make_intrusive(TArgs&&... args)
+    {
+        return IntrusivePtr<T>(new T(std::forward<TArgs>(args)...));
+    }
+} // namespace Intrusive
+
+#endif
@@ -0,0 +1,382 @@
+#ifndef LOCAL_SHARED_PTR_HPP
+#define LOCAL_SHARED_PTR_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+// local_shared_ptr & local_weak_ptr - shared ownership within one thread
+//
+// API mirrors std::shared_ptr/std::weak_ptr, but reference counts are plain
+// integers (no lock-prefixed instructions). Never share the owned object
+// (nor copies of the pointers) between threads.
+
+namespace Local
+{
+    namespace Detail
+    {
+        class ControlBlock
+        {
+            long shared_count_ = 1;
+            long weak_count_ = 1; // +1 held collectively by all shared owners
+
+        public:
+            ControlBlock() = default;
+            ControlBlock(const ControlBlock&) = delete;
+            ControlBlock& operator=(const ControlBlock&) = delete;
+
+            long use_count() const noexcept
+            {
+                return shared_count_;
+            }
+
+            void add_shared() noexcept
+            {
+                ++shared_count_;
+            }
+
+            void add_weak() noexcept
+            {
+                ++weak_count_;
+            }
+
+            void release_shared() noexcept
+            {
+                if (--shared_count_ == 0)
+                {
+                    destroy_object();
+                    release_weak();
+                }
+            }
+
+            void release_weak() noexcept
+            {
+                if (--weak_count_ == 0)
+                    delete this;
+            }
+
+        protected:
+            virtual ~ControlBlock() = default;
+
+        private:
+            virtual void destroy_object() noexcept = 0;
+        };
+
+        template <typename T>
+        class PointerBlock : public ControlBlock
+        {
+            T* ptr_;
+
+        public:
+            explicit PointerBlock(T* ptr)
+                : ptr_{ptr}
+            {
+            }
+
+        private:
+            void destroy_object() noexcept override
+            {
+                delete ptr_;
+            }
+        };
+
+        // object & counters in one allocation - used by make_local_shared
+        template <typename T>
+        class InplaceBlock : public ControlBlock
+        {
+            alignas(T) std::byte storage_[sizeof(T)];
+
+        public:
+            template <typename... TArgs>
+            explicit InplaceBlock(TArgs&&... args)
+            {
+                ::new (static_cast<void*>(storage_)) T(std::forward<TArgs>(args)...);
+            }
+
+            T* get() noexcept
+            {
+                return std::launder(reinterpret_cast<T*>(storage_));
+            }
+
+        private:
+            void destroy_object() noexcept override
+            {
+                std::destroy_at(get());
+            }
+        };
+    } // namespace Detail
+
+    template <typename T>
+    class local_weak_ptr;
+
+    template <typename T>
+    class local_shared_ptr
+    {
+        T* ptr_ = nullptr;
+        Detail::ControlBlock* control_block_ = nullptr;
+
+        template <typename U>
+        friend class local_shared_ptr;
+
+        template <typename U>
+        friend class local_weak_ptr;
+
+        template <typename U, typename... TArgs>
+        friend local_shared_ptr<U> make_local_shared(TArgs&&... args);
+
+        // adopts a reference already counted in control_block
+        local_shared_ptr(T* ptr, Detail::ControlBlock* control_block) noexcept
+            : ptr_{ptr}
+            , control_block_{control_block}
+        {
+        }
+
+    public:
+        using element_type = T;
+        using weak_type = local_weak_ptr<T>;
+
+        local_shared_ptr() noexcept = default;
+
+        local_shared_ptr(std::nullptr_t) noexcept
+        {
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        explicit local_shared_ptr(U* ptr)
+            : ptr_{ptr}
+        {
+            try
+            {
+                control_block_ = new Detail::PointerBlock<U>(ptr);
+            }
+            catch (...)
+            {
+                delete ptr;
+                throw;
+            }
+        }
+
+        local_shared_ptr(const local_shared_ptr& other) noexcept
+            : ptr_{other.ptr_}
+            , control_block_{other.control_block_}
+        {
+            if (control_block_)
+                control_block_->add_shared();
+        }
+
+        // implicit upcasts only - like std::shared_ptr
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_shared_ptr(const local_shared_ptr<U>& other) noexcept
+            : ptr_{other.ptr_}
+            , control_block_{other.control_block_}
+        {
+            if (control_block_)
+                control_block_->add_shared();
+        }
+
+        local_shared_ptr(local_shared_ptr&& other) noexcept
+            : ptr_{std::exchange(other.ptr_, nullptr)}
+            , control_block_{std::exchange(other.control_block_, nullptr)}
+        {
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_shared_ptr(local_shared_ptr<U>&& other) noexcept
+            : ptr_{std::exchange(other.ptr_, nullptr)}
+            , control_block_{std::exchange(other.control_block_, nullptr)}
+        {
+        }
+
+        local_shared_ptr& operator=(const local_shared_ptr& other) noexcept
+        {
+            local_shared_ptr temp(other);
+            swap(temp);
+
+            return *this;
+        }
+
+        local_shared_ptr& operator=(local_shared_ptr&& other) noexcept
+        {
+            local_shared_ptr temp(std::move(other));
+            swap(temp);
+
+            return *this;
+        }
+
+        ~local_shared_ptr()
+        {
+            if (control_block_)
+                control_block_->release_shared();
+        }
+
+        void swap(local_shared_ptr& other) noexcept
+        {
+            std::swap(ptr_, other.ptr_);
+            std::swap(control_block_, other.control_block_);
+        }
+
+        void reset() noexcept
+        {
+            local_shared_ptr().swap(*this);
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        void reset(U* ptr)
+        {
+            local_shared_ptr(ptr).swap(*this);
+        }
+
+        T* get() const noexcept
+        {
+            return ptr_;
+        }
+
+        T& operator*() const noexcept
+        {
+            return *ptr_;
+        }
+
+        T* operator->() const noexcept
+        {
+            return ptr_;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return ptr_ != nullptr;
+        }
+
+        long use_count() const noexcept
+        {
+            return control_block_ ? control_block_->use_count() : 0;
+        }
+
+        template <typename U>
+        bool operator==(const local_shared_ptr<U>& other) const noexcept
+        {
+            return ptr_ == other.get();
+        }
+
+        bool operator==(std::nullptr_t) const noexcept
+        {
+            return ptr_ == nullptr;
+        }
+    };
+
+    template <typename T>
+    class local_weak_ptr
+    {
+        T* ptr_ = nullptr;
+        Detail::ControlBlock* control_block_ = nullptr;
+
+        template <typename U>
+        friend class local_weak_ptr;
+
+    public:
+        using element_type = T;
+
+        local_weak_ptr() noexcept = default;
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_weak_ptr(const local_shared_ptr<U>& shared) noexcept
+            : ptr_{shared.ptr_}
+            , control_block_{shared.control_block_}
+        {
+            if (control_block_)
+                control_block_->add_weak();
+        }
+
+        local_weak_ptr(const local_weak_ptr& other) noexcept
+            : ptr_{other.ptr_}
+            , control_block_{other.control_block_}
+        {
+            if (control_block_)
+                control_block_->add_weak();
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_weak_ptr(const local_weak_ptr<U>& other) noexcept
+            : ptr_{other.ptr_}
+            , control_block_{other.control_block_}
+        {
+            if (control_block_)
+                control_block_->add_weak();
+        }
+
+        local_weak_ptr(local_weak_ptr&& other) noexcept
+            : ptr_{std::exchange(other.ptr_, nullptr)}
+            , control_block_{std::exchange(other.control_block_, nullptr)}
+        {
+        }
+
+        local_weak_ptr& operator=(const local_weak_ptr& other) noexcept
+        {
+            local_weak_ptr temp(other);
+            swap(temp);
+
+            return *this;
+        }
+
+        local_weak_ptr& operator=(local_weak_ptr&& other) noexcept
+        {
+            local_weak_ptr temp(std::move(other));
+            swap(temp);
+
+            return *this;
+        }
+
+        ~local_weak_ptr()
+        {
+            if (control_block_)
+                control_block_->release_weak();
+        }
+
+        void swap(local_weak_ptr& other) noexcept
+        {
+            std::swap(ptr_, other.ptr_);
+            std::swap(control_block_, other.control_block_);
+        }
+
+        void reset() noexcept
+        {
+            local_weak_ptr().swap(*this);
+        }
+
+        long use_count() const noexcept
+        {
+            return control_block_ ? control_block_->use_count() : 0;
+        }
+
+        bool expired() const noexcept
+        {
+            return use_count() == 0;
+        }
+
+        local_shared_ptr<T> lock() const noexcept
+        {
+            if (expired())
+                return nullptr;
+
+            control_block_->add_shared();
+            return local_shared_ptr<T>(ptr_, control_block_);
+        }
+    };
+
+    template <typename T, typename... TArgs>
+    local_shared_ptr<T> make_local_shared(TArgs&&... args)
+    {
+        auto* control_block = new Detail::InplaceBlock<T>(std::forward<TArgs>(args)...);
+        return local_shared_ptr<T>(control_block->get(), control_block);
+    }
+} // namespace Local
+
+#endif
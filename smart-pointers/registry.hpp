@@ -0,0 +1,249 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// Registry - thread-safe map: name -> shared_ptr<T>
+//
+// - sharded: each shard has its own shared_mutex (readers don't block each other)
+// - open addressing (linear probing) in a flat vector per shard
+// - lookup by string_view - no temporary std::string
+// - get_or_create() calls the factory at most once per key
+
+namespace Concurrency
+{
+    template <typename T, std::size_t ShardCount = 16>
+    class Registry
+    {
+        static_assert(std::has_single_bit(ShardCount), "ShardCount must be a power of 2");
+
+        struct Slot
+        {
+            std::size_t hash = 0;
+            std::string key;
+            std::shared_ptr<T> value; // nullptr - empty slot
+        };
+
+        struct alignas(64) Shard // no false sharing between locks of neighbouring shards
+        {
+            mutable std::shared_mutex mtx;
+            std::vector<Slot> slots;
+            std::size_t size = 0;
+        };
+
+        std::array<Shard, ShardCount> shards_;
+
+        static constexpr std::size_t initial_capacity = 16;
+        static constexpr int shard_bits = std::bit_width(ShardCount) - 1;
+
+    public:
+        Registry() = default;
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+
+        std::shared_ptr<T> find(std::string_view key) const
+        {
+            const std::size_t hash = hash_of(key);
+            const Shard& shard = shard_for(hash);
+
+            std::shared_lock lk{shard.mtx};
+            if (auto index = find_index(shard, hash, key))
+                return shard.slots[*index].value;
+
+            return nullptr;
+        }
+
+        bool contains(std::string_view key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        // factory is called under the lock of the shard - it should not use this registry
+        template <typename Factory>
+        std::shared_ptr<T> get_or_create(std::string_view key, Factory&& factory)
+        {
+            const std::size_t hash = hash_of(key);
+            Shard& shard = shard_for(hash);
+
+            {
+                std::shared_lock lk{shard.mtx};
+                if (auto index = find_index(shard, hash, key))
+                    return shard.slots[*index].value;
+            }
+
+            std::unique_lock lk{shard.mtx};
+            if (auto index = find_index(shard, hash, key)) // created by other thread in the meantime
+                return shard.slots[*index].value;
+
+            std::shared_ptr<T> value = std::invoke(std::forward<Factory>(factory));
+            if (!value)
+                throw std::invalid_argument("Factory returned nullptr");
+
+            insert_new(shard, hash, key, value);
+
+            return value;
+        }
+
+        // returns true if a new entry was inserted
+        bool insert_or_assign(std::string_view key, std::shared_ptr<T> value)
+        {
+            if (!value)
+                throw std::invalid_argument("Value can't be nullptr");
+
+            const std::size_t hash = hash_of(key);
+            Shard& shard = shard_for(hash);
+
+            std::unique_lock lk{shard.mtx};
+            if (auto index = find_index(shard, hash, key))
+            {
+                shard.slots[*index].value.swap(value); // old value is released after unlock
+                return false;
+            }
+
+            insert_new(shard, hash, key, std::move(value));
+
+            return true;
+        }
+
+        bool erase(std::string_view key)
+        {
+            const std::size_t hash = hash_of(key);
+            Shard& shard = shard_for(hash);
+
+            std::shared_ptr<T> erased; // released after unlock
+
+            std::unique_lock lk{shard.mtx};
+            auto index = find_index(shard, hash, key);
+            if (!index)
+                return false;
+
+            erased = std::move(shard.slots[*index].value);
+            erase_at(shard, *index);
+
+            return true;
+        }
+
+        std::size_t size() const
+        {
+            std::size_t total = 0;
+            for (const Shard& shard : shards_)
+            {
+                std::shared_lock lk{shard.mtx};
+                total += shard.size;
+            }
+
+            return total;
+        }
+
+    private:
+        static std::size_t hash_of(std::string_view key)
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+
+        // high bits of a mixed hash select a shard, low bits select a slot
+        Shard& shard_for(std::size_t hash)
+        {
+            return shards_[shard_index(hash)];
+        }
+
+        const Shard& shard_for(std::size_t hash) const
+        {
+            return shards_[shard_index(hash)];
+        }
+
+        static std::size_t shard_index(std::size_t hash)
+        {
+            if constexpr (shard_bits == 0)
+                return 0;
+            else
+                return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> (64 - shard_bits));
+        }
+
+        static std::optional<std::size_t> find_index(const Shard& shard, std::size_t hash, std::string_view key)
+        {
+            if (shard.slots.empty())
+                return std::nullopt;
+
+            const std::size_t mask = shard.slots.size() - 1;
+            for (std::size_t index = hash & mask;; index = (index + 1) & mask)
+            {
+                const Slot& slot = shard.slots[index];
+                if (!slot.value)
+                    return std::nullopt;
+                if (slot.hash == hash && slot.key == key)
+                    return index;
+            }
+        }
+
+        static void insert_new(Shard& shard, std::size_t hash, std::string_view key, std::shared_ptr<T> value)
+        {
+            if (4 * (shard.size + 1) > 3 * shard.slots.size()) // max load factor 0.75
+                rehash(shard, std::max(initial_capacity, 2 * shard.slots.size()));
+
+            place(shard.slots, Slot{hash, std::string(key), std::move(value)});
+            ++shard.size;
+        }
+
+        static void place(std::vector<Slot>& slots, Slot&& slot)
+        {
+            const std::size_t mask = slots.size() - 1;
+            std::size_t index = slot.hash & mask;
+            while (slots[index].value)
+                index = (index + 1) & mask;
+
+            slots[index] = std::move(slot);
+        }
+
+        static void rehash(Shard& shard, std::size_t new_capacity)
+        {
+            std::vector<Slot> new_slots(new_capacity);
+            for (Slot& slot : shard.slots)
+            {
+                if (slot.value)
+                    place(new_slots, std::move(slot));
+            }
+
+            shard.slots = std::move(new_slots);
+        }
+
+        // backward shift deletion - no tombstones, probe sequences stay short
+        static void erase_at(Shard& shard, std::size_t index)
+        {
+            std::vector<Slot>& slots = shard.slots;
+            const std::size_t mask = slots.size() - 1;
+
+            std::size_t hole = index;
+            for (std::size_t next = (hole + 1) & mask; slots[next].value; next = (next + 1) & mask)
+            {
+                const std::size_t home = slots[next].hash & mask;
+                // move the entry to the hole only if the hole lies on its probe path [home, next)
+                if (((next - home) & mask) >= ((next - hole) & mask))
+                {
+                    slots[hole] = std::move(slots[next]);
+                    hole = next;
+                }
+            }
+
+            slots[hole] = Slot{};
+            --shard.size;
+        }
+    };
+} // namespace Concurrency
+
+#endif
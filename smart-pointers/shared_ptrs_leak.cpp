@@ -1,6 +1,12 @@
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <hazard_pointers.hpp>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 class Human
 {
@@ -57,3 +63,184 @@ TEST_CASE("shared_ptrs leak - circular dependency")
 
     husband->description();
 }
+
+// partner link read without touching a shared control block - see hazard_pointers.hpp
+class LinkedHuman
+{
+public:
+    inline static std::atomic<int> destroyed_count = 0;
+
+    explicit LinkedHuman(const std::string& name)
+        : name_(name)
+    {
+    }
+
+    LinkedHuman(const LinkedHuman&) = delete;
+    LinkedHuman& operator=(const LinkedHuman&) = delete;
+
+    ~LinkedHuman()
+    {
+        ++destroyed_count;
+    }
+
+    const std::string& name() const
+    {
+        return name_;
+    }
+
+    // returns the previous partner - caller retires it (if it's no longer referenced)
+    LinkedHuman* set_partner(LinkedHuman* partner)
+    {
+        return partner_.exchange(partner);
+    }
+
+    // f is called with the partner (or nullptr) - the partner can't be deleted during the call
+    template <typename F>
+    decltype(auto) with_partner(F&& f) const
+    {
+        return Hazard::guarded_read(partner_, std::forward<F>(f));
+    }
+
+    std::string partner_name() const
+    {
+        return with_partner([](const LinkedHuman* partner) {
+            return partner ? partner->name() : std::string{};
+        });
+    }
+
+private:
+    std::atomic<LinkedHuman*> partner_{nullptr};
+    std::string name_;
+};
+
+TEST_CASE("hazard pointers - guarded read of partner link")
+{
+    const int destroyed_before = LinkedHuman::destroyed_count;
+    const int partner_changes = 1000;
+
+    LinkedHuman husband("Jan");
+    husband.set_partner(new LinkedHuman("Ewa"));
+
+    std::atomic<bool> done = false;
+    std::atomic<int> invalid_reads = 0;
+
+    {
+        std::vector<std::jthread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&] {
+                while (!done)
+                {
+                    std::string name = husband.partner_name();
+                    if (name.rfind("Ewa", 0) != 0)
+                        ++invalid_reads;
+                }
+            });
+        }
+
+        for (int i = 0; i < partner_changes; ++i)
+            Hazard::retire(husband.set_partner(new LinkedHuman("Ewa-" + std::to_string(i))));
+
+        done = true;
+    }
+
+    Hazard::retire(husband.set_partner(nullptr));
+
+    CHECK(invalid_reads == 0);
+    CHECK(Hazard::reclaim() == 0);
+    CHECK(LinkedHuman::destroyed_count - destroyed_before == partner_changes + 1);
+}
+
+namespace
+{
+    // owns the next node - retires it when destroyed
+    struct ChainNode
+    {
+        inline static int destroyed_count = 0;
+
+        std::atomic<ChainNode*> next{nullptr};
+
+        ~ChainNode()
+        {
+            ++destroyed_count;
+            Hazard::retire(next.exchange(nullptr));
+        }
+    };
+} // namespace
+
+TEST_CASE("hazard pointers - destructor of a retired object retires its links")
+{
+    const int chain_length = 10;
+
+    auto* head = new ChainNode;
+    ChainNode* tail = head;
+    for (int i = 1; i < chain_length; ++i)
+    {
+        auto* node = new ChainNode;
+        tail->next = node;
+        tail = node;
+    }
+
+    Hazard::retire(head);
+
+    CHECK(Hazard::reclaim() == 0);
+    CHECK(ChainNode::destroyed_count == chain_length);
+}
+
+TEST_CASE("hazard pointers - benchmark", "[.benchmark]")
+{
+    const int thread_count = 32;
+    const int reads = 100'000;
+
+    struct Person
+    {
+        std::string name;
+        std::weak_ptr<Person> partner;
+    };
+
+    BENCHMARK_ADVANCED("weak_ptr::lock - 32 threads")(Catch::Benchmark::Chronometer meter)
+    {
+        auto husband = std::make_shared<Person>("Jan");
+        auto wife = std::make_shared<Person>("Ewa");
+        husband->partner = wife;
+
+        meter.measure([&] {
+            std::atomic<std::size_t> total = 0;
+            {
+                std::vector<std::jthread> threads;
+                for (int t = 0; t < thread_count; ++t)
+                    threads.emplace_back([&] {
+                        std::size_t length = 0;
+                        for (int i = 0; i < reads; ++i)
+                            if (auto partner = husband->partner.lock())
+                                length += partner->name.size();
+                        total += length;
+                    });
+            }
+            return total.load();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Hazard::guarded_read - 32 threads")(Catch::Benchmark::Chronometer meter)
+    {
+        LinkedHuman husband("Jan");
+        husband.set_partner(new LinkedHuman("Ewa"));
+
+        meter.measure([&] {
+            std::atomic<std::size_t> total = 0;
+            {
+                std::vector<std::jthread> threads;
+                for (int t = 0; t < thread_count; ++t)
+                    threads.emplace_back([&] {
+                        std::size_t length = 0;
+                        for (int i = 0; i < reads; ++i)
+                            length += husband.with_partner([](const LinkedHuman* partner) { return partner ? partner->name().size() : 0; });
+                        total += length;
+                    });
+            }
+            return total.load();
+        });
+
+        Hazard::retire(husband.set_partner(nullptr));
+    };
+}
@@ -1,9 +1,28 @@
+#include "intrusive_ptr.hpp"
+#include "local_shared_ptr.hpp"
+#include "registry.hpp"
 #include "utils.hpp"
 
+#include <alloc_tracker.hpp>
+#include <array>
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <pool_allocator.hpp>
+#include <random>
+#include <shared_mutex>
+#include <snapshot.hpp>
+#include <thread>
+#include <type_traits>
 #include <vector>
-#include <map>
+
+#ifdef __linux__
+#include <fstream>
+#include <unistd.h>
+#endif
 
 using Utils::Gadget;
 
@@ -194,4 +213,674 @@ TEST_CASE("shared_ptrs")
     std::shared_ptr<Gadget> g3 = weak_g.lock();
     if (g3) // if g3 is alive
         std::cout << g3->name() << " is alive\n";
-}
\ No newline at end of file
+}
+
+TEST_CASE("concurrent registry")
+{
+    using namespace std;
+
+    Concurrency::Registry<Gadget> gadgets;
+
+    SECTION("lookup by string_view")
+    {
+        CHECK(gadgets.insert_or_assign("ipad", make_shared<Gadget>(42, "ipad")));
+
+        string_view name = "ipad";
+        shared_ptr<Gadget> g = gadgets.find(name);
+        REQUIRE(g != nullptr);
+        CHECK(g->id() == 42);
+        CHECK(gadgets.find("smartwatch") == nullptr);
+
+        CHECK_FALSE(gadgets.insert_or_assign("ipad", make_shared<Gadget>(665, "ipad")));
+        CHECK(gadgets.find("ipad")->id() == 665);
+        CHECK(gadgets.size() == 1);
+
+        CHECK(gadgets.erase("ipad"));
+        CHECK_FALSE(gadgets.erase("ipad"));
+        CHECK(gadgets.size() == 0);
+    }
+
+    SECTION("get_or_create constructs a value once")
+    {
+        atomic<int> created = 0;
+        vector<shared_ptr<Gadget>> results(8);
+
+        {
+            vector<jthread> threads;
+            for (auto& result : results)
+                threads.emplace_back([&] {
+                    result = gadgets.get_or_create("ipad", [&] {
+                        ++created;
+                        return make_shared<Gadget>(42, "ipad");
+                    });
+                });
+        }
+
+        CHECK(created == 1);
+        for (const auto& result : results)
+            CHECK(result == results.front());
+    }
+}
+
+TEST_CASE("concurrent registry - many keys")
+{
+    Concurrency::Registry<int> registry;
+
+    const int count = 10'000;
+    for (int i = 0; i < count; ++i)
+        registry.insert_or_assign("gadget-" + std::to_string(i), std::make_shared<int>(i));
+
+    for (int i = 0; i < count; i += 2)
+        REQUIRE(registry.erase("gadget-" + std::to_string(i)));
+
+    CHECK(registry.size() == count / 2);
+    for (int i = 0; i < count; ++i)
+    {
+        std::shared_ptr<int> value = registry.find("gadget-" + std::to_string(i));
+        if (i % 2 == 0)
+            REQUIRE(value == nullptr);
+        else
+            REQUIRE(*value == i);
+    }
+}
+
+namespace
+{
+    class LockedMapRegistry
+    {
+        mutable std::mutex mtx_;
+        std::map<std::string, std::shared_ptr<int>> items_;
+
+    public:
+        std::shared_ptr<int> find(std::string_view key) const
+        {
+            std::lock_guard lk{mtx_};
+            auto pos = items_.find(std::string(key));
+            return pos != items_.end() ? pos->second : nullptr;
+        }
+
+        void insert_or_assign(std::string_view key, std::shared_ptr<int> value)
+        {
+            std::lock_guard lk{mtx_};
+            items_[std::string(key)] = std::move(value);
+        }
+    };
+
+    // 95% reads / 5% writes on 1024 keys - ops are split between threads
+    template <typename TRegistry>
+    void read_mostly_load(TRegistry& registry, const std::vector<std::string>& keys, int thread_count, int ops)
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t] {
+                std::mt19937 rnd{static_cast<unsigned>(t)};
+                std::uniform_int_distribution<std::size_t> key_distr(0, keys.size() - 1);
+                std::uniform_int_distribution<int> op_distr(0, 99);
+                auto value = std::make_shared<int>(t);
+
+                for (int i = 0; i < ops / thread_count; ++i)
+                {
+                    const std::string& key = keys[key_distr(rnd)];
+                    if (op_distr(rnd) < 95)
+                        registry.find(key);
+                    else
+                        registry.insert_or_assign(key, value);
+                }
+            });
+        }
+    }
+} // namespace
+
+TEST_CASE("concurrent registry - benchmark", "[.benchmark]")
+{
+    const int ops = 1'000'000;
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1024; ++i)
+        keys.push_back("gadget-" + std::to_string(i));
+
+    for (int thread_count : {1, 4, 16, 64})
+    {
+        const std::string threads = std::to_string(thread_count) + " threads";
+
+        BENCHMARK_ADVANCED("std::map + mutex - " + threads)(Catch::Benchmark::Chronometer meter)
+        {
+            LockedMapRegistry registry;
+            for (const auto& key : keys)
+                registry.insert_or_assign(key, std::make_shared<int>(0));
+
+            meter.measure([&] { read_mostly_load(registry, keys, thread_count, ops); });
+        };
+
+        BENCHMARK_ADVANCED("Concurrency::Registry - " + threads)(Catch::Benchmark::Chronometer meter)
+        {
+            Concurrency::Registry<int> registry;
+            for (const auto& key : keys)
+                registry.insert_or_assign(key, std::make_shared<int>(0));
+
+            meter.measure([&] { read_mostly_load(registry, keys, thread_count, ops); });
+        };
+    }
+}
+
+TEST_CASE("pool allocator")
+{
+    using namespace std;
+
+    const Pool::Stats before = Pool::thread_stats();
+
+    SECTION("control block & gadget in one pooled block")
+    {
+        shared_ptr<Gadget> g = Pool::make_pooled<Gadget>(42, "ipad");
+        weak_ptr<Gadget> observer = g;
+
+        CHECK(g->id() == 42);
+        CHECK(Pool::thread_stats().allocations - before.allocations == 1);
+
+        g.reset();
+        CHECK(observer.expired());
+        CHECK(Pool::thread_stats().deallocations - before.deallocations == 0); // weak_ptr keeps the block
+
+        observer.reset();
+        CHECK(Pool::thread_stats().deallocations - before.deallocations == 1);
+    }
+
+    SECTION("freed blocks are reused")
+    {
+        void* first = Pool::allocate(48);
+        Pool::deallocate(first, 48);
+        void* second = Pool::allocate(40); // same size class
+        CHECK(second == first);
+        Pool::deallocate(second, 40);
+
+        const size_t reserved = Pool::reserved_bytes();
+        for (int i = 0; i < 100'000; ++i)
+            Pool::make_pooled<array<char, 100>>();
+        CHECK(Pool::reserved_bytes() - reserved <= Pool::chunk_size);
+    }
+
+    SECTION("objects released by other thread")
+    {
+        vector<shared_ptr<int>> items;
+        for (int i = 0; i < 1000; ++i)
+            items.push_back(Pool::make_pooled<int>(i));
+
+        jthread thd{[items = std::move(items)]() mutable { items.clear(); }};
+    }
+}
+
+namespace
+{
+#ifdef __linux__
+    size_t resident_bytes()
+    {
+        size_t total_pages = 0, resident_pages = 0;
+        std::ifstream statm{"/proc/self/statm"};
+        statm >> total_pages >> resident_pages;
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+
+    // long randomized create/destroy workload - 4 object sizes, 100k live objects
+    template <typename MakeShared>
+    size_t churn_objects(MakeShared make_shared, int operations)
+    {
+        std::mt19937_64 rnd{665};
+        std::vector<std::shared_ptr<void>> slots(100'000);
+
+        for (int i = 0; i < operations; ++i)
+        {
+            auto& slot = slots[rnd() % slots.size()];
+            switch (rnd() % 4)
+            {
+            case 0:
+                slot = make_shared.template operator()<std::array<char, 24>>();
+                break;
+            case 1:
+                slot = make_shared.template operator()<std::array<char, 56>>();
+                break;
+            case 2:
+                slot = make_shared.template operator()<std::array<char, 120>>();
+                break;
+            default:
+                slot = make_shared.template operator()<std::array<char, 200>>();
+            }
+        }
+
+        return slots.size();
+    }
+
+    auto std_make_shared = []<typename T>() { return std::make_shared<T>(); };
+    auto pool_make_shared = []<typename T>() { return Pool::make_pooled<T>(); };
+} // namespace
+
+#ifdef __linux__ // RSS is read from /proc
+TEST_CASE("pool allocator - RSS growth", "[.benchmark]")
+{
+    // run each workload in a separate process for a clean RSS baseline, e.g.:
+    // tests-smart-pointers "pool allocator - RSS growth" -c "make_shared"
+    const int operations = 5'000'000;
+
+    SECTION("make_shared")
+    {
+        const size_t rss_before = resident_bytes();
+        churn_objects(std_make_shared, operations);
+        std::cout << "make_shared - RSS growth: " << (resident_bytes() - rss_before) / 1024 << " KB\n";
+    }
+
+    SECTION("Pool::make_pooled")
+    {
+        const size_t rss_before = resident_bytes();
+        churn_objects(pool_make_shared, operations);
+        std::cout << "Pool::make_pooled - RSS growth: " << (resident_bytes() - rss_before) / 1024 << " KB; "
+                  << "reserved by pool: " << Pool::reserved_bytes() / 1024 << " KB\n";
+    }
+}
+#endif
+
+TEST_CASE("pool allocator - benchmark", "[.benchmark]")
+{
+    const int operations = 1'000'000;
+
+    BENCHMARK("make_shared - random create/destroy")
+    {
+        return churn_objects(std_make_shared, operations);
+    };
+
+    BENCHMARK("Pool::make_pooled - random create/destroy")
+    {
+        return churn_objects(pool_make_shared, operations);
+    };
+}
+
+namespace
+{
+    struct Config
+    {
+        int timeout = 0;
+        int retries = 0;
+        std::vector<int> limits = std::vector<int>(64, 0);
+    };
+} // namespace
+
+TEST_CASE("snapshot")
+{
+    Concurrency::Snapshot<Config> config{Config{100, 3}};
+
+    CHECK(config.read([](const Config& cfg) { return cfg.timeout; }) == 100);
+
+    SECTION("copy-on-write update")
+    {
+        Config before = config.load();
+
+        config.update([](Config& cfg) { cfg.timeout = 200; });
+
+        CHECK(before.timeout == 100);
+        CHECK(config.load().timeout == 200);
+        CHECK(config.version() == 1);
+    }
+
+    SECTION("batched updates are published once")
+    {
+        config.defer_update([](Config& cfg) { cfg.timeout = 500; });
+        config.defer_update([](Config& cfg) { cfg.retries = 5; });
+        CHECK(config.load().timeout == 100);
+
+        CHECK(config.flush() == 2);
+        CHECK(config.version() == 1);
+        CHECK(config.load().timeout == 500);
+        CHECK(config.load().retries == 5);
+    }
+
+    SECTION("readers see consistent versions")
+    {
+        std::atomic<bool> done = false;
+        std::atomic<int> torn_reads = 0;
+
+        {
+            std::vector<std::jthread> readers;
+            for (int i = 0; i < 4; ++i)
+                readers.emplace_back([&] {
+                    while (!done)
+                    {
+                        config.read([&](const Config& cfg) {
+                            if (cfg.timeout != 100 * cfg.retries / 3 || cfg.limits.front() != cfg.limits.back())
+                                ++torn_reads;
+                        });
+                    }
+                });
+
+            for (int i = 1; i <= 1000; ++i)
+                config.update([i](Config& cfg) {
+                    cfg.retries = 3 * i;
+                    cfg.timeout = 100 * i;
+                    std::fill(cfg.limits.begin(), cfg.limits.end(), i);
+                });
+
+            done = true;
+        }
+
+        CHECK(torn_reads == 0);
+        CHECK(config.load().timeout == 100'000);
+    }
+}
+
+TEST_CASE("snapshot - benchmark", "[.benchmark]")
+{
+    const int reader_count = 4;
+    const int reads = 250'000;
+
+    // readers vs one writer publishing new versions all the time
+    auto run = [=](auto read, auto write) {
+        std::atomic<bool> done = false;
+        std::jthread writer([&] {
+            for (int i = 0; !done; ++i)
+                write(i);
+        });
+
+        std::atomic<long> total = 0;
+        {
+            std::vector<std::jthread> readers;
+            for (int t = 0; t < reader_count; ++t)
+                readers.emplace_back([&] {
+                    long sum = 0;
+                    for (int i = 0; i < reads; ++i)
+                        sum += read(i);
+                    total += sum;
+                });
+        }
+
+        done = true;
+        return total.load();
+    };
+
+    BENCHMARK("shared_mutex + shared_ptr")
+    {
+        std::shared_mutex mtx;
+        auto config = std::make_shared<const Config>();
+
+        return run(
+            [&](int i) {
+                std::shared_ptr<const Config> current;
+                {
+                    std::shared_lock lk{mtx};
+                    current = config;
+                }
+                return current->limits[i % 64];
+            },
+            [&](int i) {
+                auto updated = std::make_shared<Config>(*config);
+                updated->timeout = i;
+                std::unique_lock lk{mtx};
+                config = std::move(updated);
+            });
+    };
+
+    BENCHMARK("Concurrency::Snapshot")
+    {
+        Concurrency::Snapshot<Config> config;
+
+        return run(
+            [&](int i) { return config.read([i](const Config& cfg) { return cfg.limits[i % 64]; }); },
+            [&](int i) { config.update([i](Config& cfg) { cfg.timeout = i; }); });
+    };
+}
+
+TEST_CASE("local_shared_ptrs")
+{
+    using namespace std;
+    using namespace Local;
+
+    map<string, local_shared_ptr<Gadget>> gadgets;
+
+    local_weak_ptr<Gadget> observer;
+
+    {
+        local_shared_ptr<Gadget> g1 = make_local_shared<Gadget>(42, "ipad");
+        local_shared_ptr<Gadget> g2 = g1;
+        CHECK(g1.use_count() == 2);
+
+        gadgets.emplace("ipad", g1);
+        CHECK(g1.use_count() == 3);
+
+        observer = g1;
+        CHECK(observer.use_count() == 3);
+    }
+
+    if (local_shared_ptr<Gadget> living_gadget = observer.lock())
+    {
+        CHECK(living_gadget->id() == 42);
+        CHECK(living_gadget.use_count() == 2);
+    }
+
+    gadgets.clear(); // now ipad is deleted
+
+    CHECK(observer.expired());
+    CHECK(observer.lock() == nullptr);
+
+    local_shared_ptr<Gadget> g3{new Gadget(665, "smartwatch")};
+    CHECK(g3.use_count() == 1);
+}
+
+TEST_CASE("local_shared_ptrs - refcount churn benchmark", "[.benchmark]")
+{
+    // each assignment increments one count & decrements another - 10M pairs per run
+    const int count = 1024;
+    const int rounds = 10'000;
+
+    BENCHMARK_ADVANCED("std::shared_ptr - copy assignment")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::shared_ptr<int>> items, slots(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(std::make_shared<int>(i));
+
+        meter.measure([&] {
+            for (int r = 0; r < rounds; ++r)
+                for (int i = 0; i < count; ++i)
+                    slots[i] = items[(i + r) % count];
+            return items[0].use_count();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Local::local_shared_ptr - copy assignment")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Local::local_shared_ptr<int>> items, slots(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(Local::make_local_shared<int>(i));
+
+        meter.measure([&] {
+            for (int r = 0; r < rounds; ++r)
+                for (int i = 0; i < count; ++i)
+                    slots[i] = items[(i + r) % count];
+            return items[0].use_count();
+        });
+    };
+}
+
+class SharedGadget : public Gadget, public Intrusive::RefCounted<SharedGadget>
+{
+public:
+    using Gadget::Gadget;
+};
+
+TEST_CASE("intrusive ptrs")
+{
+    using namespace std;
+    using namespace Intrusive;
+
+    static_assert(sizeof(IntrusivePtr<SharedGadget>) == sizeof(SharedGadget*));
+
+    map<string, IntrusivePtr<SharedGadget>> gadgets;
+
+    {
+        IntrusivePtr<SharedGadget> g1 = make_intrusive<SharedGadget>(42, "ipad");
+        IntrusivePtr<SharedGadget> g2 = g1;
+        CHECK(g1.use_count() == 2);
+
+        gadgets.emplace("ipad", g1);
+        CHECK(g1.use_count() == 3);
+
+        SECTION("conversion from this")
+        {
+            SharedGadget* raw_ptr = g1.get();
+            IntrusivePtr<SharedGadget> g3 = raw_ptr->intrusive_from_this();
+            CHECK(g3 == g1);
+            CHECK(g1.use_count() == 4);
+        }
+    }
+
+    CHECK(gadgets["ipad"]->id() == 42);
+    CHECK(gadgets["ipad"].use_count() == 1);
+
+    gadgets.clear(); // now ipad is deleted
+}
+
+namespace
+{
+    struct Shape : Intrusive::RefCounted<Shape>
+    {
+        virtual ~Shape() = default;
+    };
+
+    struct Circle : Shape
+    {
+    };
+} // namespace
+
+TEST_CASE("intrusive ptrs - conversions")
+{
+    using Intrusive::IntrusivePtr;
+
+    static_assert(std::is_convertible_v<IntrusivePtr<Circle>, IntrusivePtr<Shape>>);
+    static_assert(std::is_convertible_v<IntrusivePtr<Shape>, IntrusivePtr<const Shape>>);
+    static_assert(!std::is_constructible_v<IntrusivePtr<Circle>, const IntrusivePtr<Shape>&>);
+    static_assert(!std::is_constructible_v<IntrusivePtr<Circle>, IntrusivePtr<Shape>&&>);
+    static_assert(!std::is_constructible_v<IntrusivePtr<Shape>, IntrusivePtr<const Shape>>);
+
+    IntrusivePtr<Circle> circle = Intrusive::make_intrusive<Circle>();
+    IntrusivePtr<Shape> shape = circle;
+    CHECK(circle.use_count() == 2);
+
+    IntrusivePtr<Shape> moved = std::move(circle);
+    CHECK(circle == nullptr);
+    CHECK(moved == shape);
+    CHECK(shape.use_count() == 2);
+}
+
+TEST_CASE("local_shared_ptrs - conversions")
+{
+    using Local::local_shared_ptr;
+    using Local::local_weak_ptr;
+
+    static_assert(std::is_convertible_v<local_shared_ptr<Circle>, local_shared_ptr<Shape>>);
+    static_assert(!std::is_convertible_v<local_shared_ptr<Shape>, local_shared_ptr<Circle>>);
+    static_assert(!std::is_constructible_v<local_shared_ptr<Circle>, const local_shared_ptr<Shape>&>);
+    static_assert(!std::is_constructible_v<local_shared_ptr<Circle>, Shape*>);
+    static_assert(!std::is_assignable_v<local_shared_ptr<Circle>&, local_shared_ptr<Shape>>);
+    static_assert(!std::is_constructible_v<local_weak_ptr<Circle>, const local_shared_ptr<Shape>&>);
+
+    local_shared_ptr<Circle> circle = Local::make_local_shared<Circle>();
+    local_shared_ptr<Shape> shape = circle;
+    CHECK(circle.use_count() == 2);
+
+    local_weak_ptr<Shape> observer = circle;
+    local_shared_ptr<Shape> moved = std::move(circle);
+    CHECK(circle == nullptr);
+    CHECK(moved == shape);
+    CHECK(observer.use_count() == 2);
+}
+
+namespace
+{
+    struct Payload
+    {
+        int value;
+    };
+
+    struct IntrusivePayload : Intrusive::RefCounted<IntrusivePayload>
+    {
+        int value;
+
+        explicit IntrusivePayload(int v)
+            : value{v}
+        {
+        }
+    };
+
+    struct LocalPayload : Intrusive::RefCounted<LocalPayload, Intrusive::NonAtomicCounter>
+    {
+        int value;
+
+        explicit LocalPayload(int v)
+            : value{v}
+        {
+        }
+    };
+} // namespace
+
+TEST_CASE("intrusive ptrs - memory footprint")
+{
+    const int count = 1000;
+
+    AllocTracker::Scope shared_scope;
+    {
+        std::vector<std::shared_ptr<Payload>> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(std::make_shared<Payload>(i));
+    }
+    const auto shared_bytes = shared_scope.bytes_allocated();
+
+    AllocTracker::Scope intrusive_scope;
+    {
+        std::vector<Intrusive::IntrusivePtr<IntrusivePayload>> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(Intrusive::make_intrusive<IntrusivePayload>(i));
+    }
+    const auto intrusive_bytes = intrusive_scope.bytes_allocated();
+
+    std::cout << "shared_ptr: " << shared_bytes / count << " bytes/object; "
+              << "IntrusivePtr: " << intrusive_bytes / count << " bytes/object\n";
+
+    CHECK(intrusive_bytes < shared_bytes);
+}
+
+TEST_CASE("intrusive ptrs - benchmark", "[.benchmark]")
+{
+    const int count = 10'000'000;
+
+    BENCHMARK("shared_ptr - create, copy, destroy")
+    {
+        std::vector<std::shared_ptr<Payload>> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(std::make_shared<Payload>(i));
+
+        std::vector<std::shared_ptr<Payload>> copies = items;
+        return copies.size();
+    };
+
+    BENCHMARK("IntrusivePtr (atomic) - create, copy, destroy")
+    {
+        std::vector<Intrusive::IntrusivePtr<IntrusivePayload>> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(Intrusive::make_intrusive<IntrusivePayload>(i));
+
+        std::vector<Intrusive::IntrusivePtr<IntrusivePayload>> copies = items;
+        return copies.size();
+    };
+
+    BENCHMARK("IntrusivePtr (non-atomic) - create, copy, destroy")
+    {
+        std::vector<Intrusive::IntrusivePtr<LocalPayload>> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i)
+            items.push_back(Intrusive::make_intrusive<LocalPayload>(i));
+
+        std::vector<Intrusive::IntrusivePtr<LocalPayload>> copies = items;
+        return copies.size();
+    };
+}